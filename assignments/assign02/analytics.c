@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "analytics.h"
+
+analytics_t analytics;
+
+// Prompt bookkeeping for the reaction time measurement
+static bool     prompt_armed = false;
+static int      prompt_level = 0;
+static int      prompt_char = -1;
+static uint32_t prompt_time = 0;
+
+// Increment a 16-bit counter without wrapping it back to zero
+static inline void sat_inc(uint16_t *counter) {
+    if (*counter != UINT16_MAX) (*counter)++;
+}
+
+// Clamp a microsecond value into a histogram bucket
+static inline int bucket_of(uint32_t us, int shift) {
+    uint32_t b = us >> shift;
+    return b < ANALYTICS_BUCKETS ? (int)b : ANALYTICS_BUCKETS - 1;
+}
+
+static inline bool level_valid(int level) {
+    return 0 < level && level <= ANALYTICS_LEVELS;
+}
+
+// Map a character to its char_array index in O(1), or -1 if not a digit / capital letter
+int analytics_char_index(char c) {
+    if ('0' <= c && c <= '9') return c - '0';
+    if ('A' <= c && c <= 'Z') return c - 'A' + 10;
+    return -1;
+}
+
+// Called whenever a new question is printed, starts the reaction time measurement
+void analytics_prompt(int level, char expected, uint32_t now_us) {
+    prompt_level = level;
+    prompt_char = analytics_char_index(expected);
+    prompt_time = now_us;
+    prompt_armed = level_valid(level);
+}
+
+// Called from the GPIO ISR on every press, only the first press after a prompt counts
+void analytics_key_down(uint32_t now_us) {
+    if (!prompt_armed) return;
+    prompt_armed = false;
+
+    uint32_t delta = now_us - prompt_time;
+    uint32_t ms = delta / 1000;
+    int l = prompt_level - 1;
+
+    sat_inc(&analytics.reaction_hist[l][bucket_of(delta, REACTION_BUCKET_SHIFT)]);
+    analytics.reaction_sum_ms[l] += ms;
+    sat_inc(&analytics.reaction_count[l]);
+
+    if (prompt_char >= 0) {
+        analytics.char_reaction_sum_ms[prompt_char] += ms;
+        sat_inc(&analytics.char_reaction_count[prompt_char]);
+    }
+}
+
+// Called from add_dot()/add_dash() with the hold time measured in the GPIO ISR
+void analytics_element(int level, int element, uint32_t hold_us) {
+    if (!level_valid(level)) return;
+    int l = level - 1;
+
+    int32_t err = (int32_t)hold_us - (element == ANALYTICS_DASH ? NOMINAL_DASH_TIME : NOMINAL_DOT_TIME);
+    uint32_t abs_err = err < 0 ? (uint32_t)(-err) : (uint32_t)err;
+
+    sat_inc(&analytics.timing_hist[l][element][bucket_of(abs_err, TIMING_BUCKET_SHIFT)]);
+    analytics.timing_err_sum_ms[l][element] += err / 1000;
+    sat_inc(&analytics.timing_count[l][element]);
+}
+
+/*
+    Score an answer character by character against the expected
+    string. A short answer normally counts the missing letters as
+    misses, but a round cut short by fail-fast never gave the player
+    the chance to key them, so only what was entered is scored.
+*/
+void analytics_answer(int level, const char *expected, const char *got, bool cut_short) {
+    if (!level_valid(level)) return;
+    int l = level - 1;
+    bool ended = false;
+
+    for (int j = 0; expected[j] != '\0'; j++) {
+        int c = analytics_char_index(expected[j]);
+        if (c < 0) continue;
+
+        if (!ended && got[j] == '\0') ended = true;
+        if (ended && cut_short) break;
+
+        if (!ended && got[j] == expected[j]) sat_inc(&analytics.hits[l][c]);
+        else sat_inc(&analytics.misses[l][c]);
+    }
+}
+
+// Ratio in tenths of a percent, rounded to nearest, using only integer maths
+uint32_t analytics_permille(uint32_t part, uint32_t total) {
+    if (total == 0) return 0;
+    return (part * 1000 + total / 2) / total;
+}
+
+static void print_hist(const char *label, const uint16_t *hist) {
+    printf("█▓▒░   %-10s|", label);
+    for (int b = 0; b < ANALYTICS_BUCKETS; b++) printf("%4u", hist[b]);
+    printf("\n");
+}
+
+// Print the summary of everything recorded since power-up
+void analytics_screen() {
+    printf("█▓▒░ TRAINING ANALYTICS\n");
+    printf("█▓▒░ Reaction buckets are 262ms wide, timing error buckets are 16ms wide.\n█▓▒░\n");
+
+    for (int l = 0; l < ANALYTICS_LEVELS; l++) {
+        uint32_t hits = 0, misses = 0;
+        for (int c = 0; c < ANALYTICS_CHARS; c++) {
+            hits += analytics.hits[l][c];
+            misses += analytics.misses[l][c];
+        }
+
+        uint32_t acc = analytics_permille(hits, hits + misses);
+        uint32_t react = analytics.reaction_count[l] ? analytics.reaction_sum_ms[l] / analytics.reaction_count[l] : 0;
+
+        printf("█▓▒░ LEVEL-0%d: %u/%u characters correct (%u.%u%%), mean reaction %ums\n",
+               l + 1, hits, hits + misses, acc / 10, acc % 10, react);
+
+        for (int e = 0; e < 2; e++) {
+            int32_t bias = analytics.timing_count[l][e] ? analytics.timing_err_sum_ms[l][e] / analytics.timing_count[l][e] : 0;
+            printf("█▓▒░   %s: %u keyed, mean error %+dms\n", e == ANALYTICS_DOT ? "Dots " : "Dashes",
+                   analytics.timing_count[l][e], bias);
+        }
+
+        print_hist("reaction", analytics.reaction_hist[l]);
+        print_hist("dot err", analytics.timing_hist[l][ANALYTICS_DOT]);
+        print_hist("dash err", analytics.timing_hist[l][ANALYTICS_DASH]);
+    }
+
+    // Characters with the worst accuracy across all levels
+    printf("█▓▒░\n█▓▒░ Weakest characters:");
+    for (int c = 0; c < ANALYTICS_CHARS; c++) {
+        uint32_t hits = 0, misses = 0;
+        for (int l = 0; l < ANALYTICS_LEVELS; l++) {
+            hits += analytics.hits[l][c];
+            misses += analytics.misses[l][c];
+        }
+        if (misses == 0) continue;
+
+        uint32_t acc = analytics_permille(hits, hits + misses);
+        uint32_t react = analytics.char_reaction_count[c] ? analytics.char_reaction_sum_ms[c] / analytics.char_reaction_count[c] : 0;
+        printf(" %c(%u%%,%ums)", c < 10 ? '0' + c : 'A' + c - 10, acc / 10, react);
+    }
+    printf("\n");
+}
+
+/*
+    Binary export, framed as:
+        uint32  ANALYTICS_MAGIC
+        uint16  ANALYTICS_VERSION
+        uint16  payload length
+        ...     analytics_t (little-endian)
+        uint16  Fletcher-16 checksum of the payload
+
+    putchar_raw() bypasses the stdio CR/LF translation so the bytes arrive untouched.
+*/
+static void put_bytes(const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) putchar_raw(data[i]);
+}
+
+void analytics_export() {
+    uint32_t magic = ANALYTICS_MAGIC;
+    uint16_t version = ANALYTICS_VERSION;
+    uint16_t len = sizeof(analytics);
+    const uint8_t *payload = (const uint8_t *)&analytics;
+
+    uint16_t sum1 = 0, sum2 = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        sum1 = (sum1 + payload[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    uint16_t checksum = (sum2 << 8) | sum1;
+
+    put_bytes((const uint8_t *)&magic, sizeof(magic));
+    put_bytes((const uint8_t *)&version, sizeof(version));
+    put_bytes((const uint8_t *)&len, sizeof(len));
+    put_bytes(payload, len);
+    put_bytes((const uint8_t *)&checksum, sizeof(checksum));
+    stdio_flush();
+}
+
+void analytics_reset() {
+    memset(&analytics, 0, sizeof(analytics));
+    prompt_armed = false;
+}
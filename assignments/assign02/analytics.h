@@ -0,0 +1,63 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "morse_timing.h"
+
+/*
+    Training Analytics
+
+    Everything here is integer / fixed point so that none of the
+    hot paths (GPIO and ALARM interrupts) ever touch the soft-float
+    libraries. Every record function is O(1): a table index and a
+    saturating counter increment, nothing more.
+*/
+
+#define ANALYTICS_LEVELS    4           // Levels 1 - 4
+#define ANALYTICS_CHARS     36          // Digits 0 - 9 then Letters A - Z (same order as char_array)
+#define ANALYTICS_BUCKETS   16          // Number of buckets in every histogram
+
+#define ANALYTICS_DOT       0           // Element index for a Dot
+#define ANALYTICS_DASH      1           // Element index for a Dash
+
+// Histogram bucket widths, as right shifts of a microsecond value (powers of two like the ASM timings)
+#define REACTION_BUCKET_SHIFT   18      // 0x00040000 us = 262.144 ms per reaction time bucket
+#define TIMING_BUCKET_SHIFT     14      // 0x00004000 us =  16.384 ms per timing error bucket
+
+// Ideal element lengths. MORSE_DOT_TIME is the 2-unit midpoint between a 1-unit dot and a 3-unit dash.
+#define NOMINAL_DOT_TIME    (MORSE_DOT_TIME / 2)        // 1 unit  =  98.304 ms
+#define NOMINAL_DASH_TIME   (MORSE_DOT_TIME / 2 * 3)    // 3 units = 294.912 ms
+
+#define ANALYTICS_MAGIC     0x3141434D  // "MCA1" when sent little-endian
+#define ANALYTICS_VERSION   1
+
+typedef struct {
+    // Per level, per character answer results
+    uint16_t hits[ANALYTICS_LEVELS][ANALYTICS_CHARS];
+    uint16_t misses[ANALYTICS_LEVELS][ANALYTICS_CHARS];
+
+    // Reaction time from the prompt being printed to the first key-down
+    uint16_t reaction_hist[ANALYTICS_LEVELS][ANALYTICS_BUCKETS];
+    uint32_t reaction_sum_ms[ANALYTICS_LEVELS];
+    uint16_t reaction_count[ANALYTICS_LEVELS];
+    uint32_t char_reaction_sum_ms[ANALYTICS_CHARS];
+    uint16_t char_reaction_count[ANALYTICS_CHARS];
+
+    // Absolute dot/dash length error against the nominal element, plus a signed sum to show bias
+    uint16_t timing_hist[ANALYTICS_LEVELS][2][ANALYTICS_BUCKETS];
+    int32_t  timing_err_sum_ms[ANALYTICS_LEVELS][2];
+    uint16_t timing_count[ANALYTICS_LEVELS][2];
+} analytics_t;
+
+int  analytics_char_index(char c);
+void analytics_prompt(int level, char expected, uint32_t now_us);
+void analytics_key_down(uint32_t now_us);
+void analytics_element(int level, int element, uint32_t hold_us);
+void analytics_answer(int level, const char *expected, const char *got, bool cut_short);
+uint32_t analytics_permille(uint32_t part, uint32_t total);
+void analytics_screen();
+void analytics_export();
+void analytics_reset();
+
+#endif
@@ -1,17 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <math.h>
 #include <time.h>
 #include <string.h>
 #include <stdbool.h>
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/clocks.h"
-#include "pico/float.h"                 // Required for using single-precision variables.
-#include "pico/double.h"                // Required for using double-precision variables.
 #include "hardware/pio.h"
 #include "ws2812.pio.h"
 #include "hardware/watchdog.h"
+#include "analytics.h"
+#include "boot.h"
+#include "morse_decoder.h"
+#include "scheduler.h"
 
 #define IS_RGBW true        // Will use RGBW format
 #define NUM_PIXELS 1        // There is 1 WS2812 device in the chain
@@ -50,23 +51,6 @@ static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
 
 
 
-char char_array[] = {
-    // Digits 0 - 9
-    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 
-    // Letters A - Z
-    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'};
-char morse_table[36][6] = { // Must declare as a char pointer array to get an array of strings since this is in C not C++
-    // Digits 0 - 9
-    "-----\0", ".----\0", "..---\0", "...--\0", "....-\0", ".....\0",
-    "-....\0", "--...\0", "---..\0", "----.\0", 
-    // Letters A - Z
-    ".-\0", "-...\0", "-.-.\0", "-..\0", ".\0", "..-.\0", "--.\0", "....\0",
-    "..\0", ".---\0", "-.-\0", ".-..\0", "--\0", "-.\0", "---\0", ".--.\0",
-    "--.-\0", ".-.\0", "...\0", "-\0", "..-\0", "...-\0", ".--\0", "-..-\0",
-    "-.--\0", "--..\0",
-}; 
-
-
 // Game Variables
 #define MAX_LIVES 3
 #define CONSECUTIVE_TO_WIN 5
@@ -96,12 +80,15 @@ int levelsCompleted[4]= {0,0,0,0};
 int mode = 0;
 int level = 0;
 
+// Welcome screen is drawn from the main loop once start-up has finished, not during boot
+volatile bool splash_pending = true;
+
 // Level 1 & 2 Variables
 int rand_num;
 
 // Function declarations
-void add_dot();
-void add_dash();
+void add_dot(uint32_t hold_time);
+void add_dash(uint32_t hold_time);
 void end_char();
 void end_sequence();
 void add_char();
@@ -120,11 +107,18 @@ int morse_index = 0;
 char input[MAX_INPUT];
 int input_index = 0;
 
+// Set when fail-fast fails a word part way through, the rest of it is discarded until the sequence gap runs out
+volatile bool draining = false;
+
+// The next prompt, held back until the drain ends so it can't be answered while input is being discarded
+void (*deferred_prompt)() = NULL;
+
 /* ---FUNCTIONS--- */
 
 
 // Must declare the main assembly entry point before use.
 void main_asm();
+void capture_init();
 
 void watchdog_update();
 void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
@@ -169,6 +163,9 @@ void menu_screen() {
     printf("█▓▒░ \"..---\" - LEVEL 02 - CHARS (HARD) %s\n", levelsCompleted[1] ? "(Completed)" : "           ");
     printf("█▓▒░ \"...--\" - LEVEL 03 - WORDS (EASY) %s\n", levelsCompleted[2] ? "(Completed)" : "           ");
     printf("█▓▒░ \"....-\" - LEVEL 04 - WORDS (HARD) %s\n", levelsCompleted[3] ? "(Completed)" : "           ");
+    printf("█▓▒░ \".....\" - TRAINING ANALYTICS\n");
+    printf("█▓▒░ \"-....\" - EXPORT ANALYTICS (BINARY)\n");
+    printf("█▓▒░ \"--...\" - BOOT TIMELINE\n");
 }
 
 // Print the opening screen with rules explaining the game
@@ -204,6 +201,20 @@ void welcome_screen() {
     lower_edge();
 }
 
+// Welcome screen for the fast boot path, straight to the menu without the banners
+void quick_welcome_screen() {
+    clear_screen();
+    mode = 0;
+    update_LED();
+
+    reset_game_params();
+
+    upper_edge();
+    printf("█▓▒░ Recovered from a watchdog reset.\n");
+    menu_screen();
+    lower_edge();
+}
+
 void end_screen() {
     // Update LED Colour
     clear_screen();
@@ -350,8 +361,8 @@ void update_LED() {
 
 // Level 3 & 4 variables
 //char words[20][20] = {"HI\0", "DOG\0", "ICE\0", "WOW\0", "DAY\0"};
-char words[600][6] = {"ABA\0", "ABS\0", "ACE\0", "ACT\0", "ADD\0", "ADO\0", "AFT\0", "AGE\0", "AGO\0", "AHA\0", "AID\0", "AIM\0", "AIR\0", "ALA\0", "ALE\0", "ALL\0", "ALT\0", "AMP\0", "ANA\0", "AND\0", "ANT\0", "ANY\0", "APE\0", "APP\0", "APT\0", "ARC\0", "ARE\0", "ARK\0", "ARM\0", "ART\0", "ASH\0", "ASK\0", "ASP\0", "ASS\0", "ATE\0", "AVE\0", "AWE\0", "AXE\0", "AYE\0", "BAA\0", "BAD\0", "BAG\0", "BAN\0", "BAR\0", "BAT\0", "BAY\0", "BED\0", "BEE\0", "BEG\0", "BEL\0", "BEN\0", "BET\0", "BID\0", "BIG\0", "BIN\0", "BIO\0", "BIS\0", "BIT\0", "BIZ\0", "BOB\0", "BOG\0", "BOO\0", "BOW\0", "BOX\0", "BOY\0", "BRA\0", "BUD\0", "BUG\0", "BUM\0", "BUN\0", "BUS\0", "BUT\0", "BUY\0", "BYE\0", "CAB\0", "CAD\0", "CAM\0", "CAN\0", "CAP\0", "CAR\0", "CAT\0", "CHI\0", "COB\0", "COD\0", "COL\0", "CON\0", "COO\0", "COP\0", "COR\0", "COS\0", "COT\0", "COW\0", "COX\0", "COY\0", "CRY\0", "CUB\0", "CUE\0", "CUM\0", "CUP\0", "CUT\0", "DAB\0", "DAD\0", "DAL\0", "DAM\0", "DAN\0", "DAY\0", "DEE\0", "DEF\0", "DEL\0", "DEN\0", "DEW\0", "DID\0", "DIE\0", "DIG\0", "DIM\0", "DIN\0", "DIP\0", "DIS\0", "DOC\0", "DOE\0", "DOG\0", "DON\0", "DOT\0", "DRY\0", "DUB\0", "DUE\0", "DUG\0", "DUN\0", "DUO\0", "DYE\0", "EAR\0", "EAT\0", "EBB\0", "ECU\0", "EFT\0", "EGG\0", "EGO\0", "ELF\0", "ELM\0", "EMU\0", "END\0", "ERA\0", "ETA\0", "EVE\0", "EYE\0", "FAB\0", "FAD\0", "FAN\0", "FAR\0", "FAT\0", "FAX\0", "FAY\0", "FED\0", "FEE\0", "FEN\0", "FEW\0", "FIG\0", "FIN\0", "FIR\0", "FIT\0", "FIX\0", "FLU\0", "FLY\0", "FOE\0", "FOG\0", "FOR\0", "FOX\0", "FRY\0", "FUN\0", "FUR\0", "GAG\0", "GAL\0", "GAP\0", "GAS\0", "GAY\0", "GEE\0", "GEL\0", "GEM\0", "GET\0", "GIG\0", "GIN\0", "GOD\0", "GOT\0", "GUM\0", "GUN\0", "GUT\0", "GUY\0", "GYM\0", "HAD\0", "HAM\0", "HAS\0", "HAT\0", "HAY\0", "HEM\0", "HEN\0", "HER\0", "HEY\0", "HID\0", "HIM\0", "HIP\0", "HIS\0", "HIT\0", "HOG\0", "HON\0", "HOP\0", "HOT\0", "HOW\0", "HUB\0", "HUE\0", "HUG\0", "HUH\0", "HUM\0", "HUT\0", "ICE\0", "ICY\0", "IGG\0", "ILL\0", "IMP\0", "INK\0", "INN\0", "ION\0", "ITS\0", "IVY\0", "JAM\0", "JAR\0", "JAW\0", "JAY\0", "JET\0", "JEW\0", "JOB\0", "JOE\0", "JOG\0", "JOY\0", "JUG\0", "JUN\0", "KAY\0", "KEN\0", "KEY\0", "KID\0", "KIN\0", "KIT\0", "LAB\0", "LAC\0", "LAD\0", "LAG\0", "LAM\0", "LAP\0", "LAW\0", "LAX\0", "LAY\0", "LEA\0", "LED\0", "LEE\0", "LEG\0", "LES\0", "LET\0", "LIB\0", "LID\0", "LIE\0", "LIP\0", "LIT\0", "LOG\0", "LOT\0", "LOW\0", "MAC\0", "MAD\0", "MAG\0", "MAN\0", "MAP\0", "MAR\0", "MAS\0", "MAT\0", "MAX\0", "MAY\0", "MED\0", "MEG\0", "MEN\0", "MET\0", "MID\0", "MIL\0", "MIX\0", "MOB\0", "MOD\0", "MOL\0", "MOM\0", "MON\0", "MOP\0", "MOT\0", "MUD\0", "MUG\0", "MUM\0", "NAB\0", "NAH\0", "NAN\0", "NAP\0", "NAY\0", "NEB\0", "NEG\0", "NET\0", "NEW\0", "NIL\0", "NIP\0", "NOD\0", "NOR\0", "NOS\0", "NOT\0", "NOW\0", "NUN\0", "NUT\0", "OAK\0", "ODD\0", "OFF\0", "OFT\0", "OIL\0", "OLD\0", "OLE\0", "ONE\0", "OOH\0", "OPT\0", "ORB\0", "ORE\0", "OUR\0", "OUT\0", "OWE\0", "OWL\0", "OWN\0", "PAC\0", "PAD\0", "PAL\0", "PAM\0", "PAN\0", "PAP\0", "PAR\0", "PAS\0", "PAT\0", "PAW\0", "PAY\0", "PEA\0", "PEG\0", "PEN\0", "PEP\0", "PER\0", "PET\0", "PEW\0", "PHI\0", "PIC\0", "PIE\0", "PIG\0", "PIN\0", "PIP\0", "PIT\0", "PLY\0", "POD\0", "POL\0", "POP\0", "POT\0", "PRO\0", "PSI\0", "PUB\0", "PUP\0", "PUT\0", "RAD\0", "RAG\0", "RAJ\0", "RAM\0", "RAN\0", "RAP\0", "RAT\0", "RAW\0", "RAY\0", "RED\0", "REF\0", "REG\0", "REM\0", "REP\0", "REV\0", "RIB\0", "RID\0", "RIG\0", "RIM\0", "RIP\0", "ROB\0", "ROD\0", "ROE\0", "ROT\0", "ROW\0", "RUB\0", "RUE\0", "RUG\0", "RUM\0", "RUN\0", "RYE\0", "SAB\0", "SAC\0", "SAD\0", "SAE\0", "SAG\0", "SAL\0", "SAP\0", "SAT\0", "SAW\0", "SAY\0", "SEA\0", "SEC\0", "SEE\0", "SEN\0", "SET\0", "SEW\0", "SEX\0", "SHE\0", "SHY\0", "SIC\0", "SIM\0", "SIN\0", "SIP\0", "SIR\0", "SIS\0", "SIT\0", "SIX\0", "SKI\0", "SKY\0", "SLY\0", "SOD\0", "SOL\0", "SON\0", "SOW\0", "SOY\0", "SPA\0", "SPY\0", "SUB\0", "SUE\0", "SUM\0", "SUN\0", "SUP\0", "TAB\0", "TAD\0", "TAG\0", "TAM\0", "TAN\0", "TAP\0", "TAR\0", "TAT\0", "TAX\0", "TEA\0", "TED\0", "TEE\0", "TEN\0", "THE\0", "THY\0", "TIE\0", "TIN\0", "TIP\0", "TOD\0", "TOE\0", "TOM\0", "TON\0", "TOO\0", "TOP\0", "TOR\0", "TOT\0", "TOW\0", "TOY\0", "TRY\0", "TUB\0", "TUG\0", "TWO\0", "USE\0", "VAN\0", "VAT\0", "VET\0", "VIA\0", "VIE\0", "VOW\0", "WAN\0", "WAR\0", "WAS\0", "WAX\0", "WAY\0", "WEB\0", "WED\0", "WEE\0", "WET\0", "WHO\0", "WHY\0", "WIG\0", "WIN\0", "WIS\0", "WIT\0", "WON\0", "WOO\0", "WOW\0", "WRY\0", "WYE\0", "YEN\0", "YEP\0", "YES\0", "YET\0", "YOU\0", "ZIP\0", "ZOO\0"};
-char morse[600][20] = {".- -... .-\0", ".- -... ...\0", ".- -.-. .\0", ".- -.-. -\0", ".- -.. -..\0", ".- -.. ---\0", ".- ..-. -\0", ".- --. .\0", ".- --. ---\0", ".- .... .-\0", ".- .. -..\0", ".- .. --\0", ".- .. .-.\0", ".- .-.. .-\0", ".- .-.. .\0", ".- .-.. .-..\0", ".- .-.. -\0", ".- -- .--.\0", ".- -. .-\0", ".- -. -..\0", ".- -. -\0", ".- -. -.--\0", ".- .--. .\0", ".- .--. .--.\0", ".- .--. -\0", ".- .-. -.-.\0", ".- .-. .\0", ".- .-. -.-\0", ".- .-. --\0", ".- .-. -\0", ".- ... ....\0", ".- ... -.-\0", ".- ... .--.\0", ".- ... ...\0", ".- - .\0", ".- ...- .\0", ".- .-- .\0", ".- -..- .\0", ".- -.-- .\0", "-... .- .-\0", "-... .- -..\0", "-... .- --.\0", "-... .- -.\0", "-... .- .-.\0", "-... .- -\0", "-... .- -.--\0", "-... . -..\0", "-... . .\0", "-... . --.\0", "-... . .-..\0", "-... . -.\0", "-... . -\0", "-... .. -..\0", "-... .. --.\0", "-... .. -.\0", "-... .. ---\0", "-... .. ...\0", "-... .. -\0", "-... .. --..\0", "-... --- -...\0", "-... --- --.\0", "-... --- ---\0", "-... --- .--\0", "-... --- -..-\0", "-... --- -.--\0", "-... .-. .-\0", "-... ..- -..\0", "-... ..- --.\0", "-... ..- --\0", "-... ..- -.\0", "-... ..- ...\0", "-... ..- -\0", "-... ..- -.--\0", "-... -.-- .\0", "-.-. .- -...\0", "-.-. .- -..\0", "-.-. .- --\0", "-.-. .- -.\0", "-.-. .- .--.\0", "-.-. .- .-.\0", "-.-. .- -\0", "-.-. .... ..\0", "-.-. --- -...\0", "-.-. --- -..\0", "-.-. --- .-..\0", "-.-. --- -.\0", "-.-. --- ---\0", "-.-. --- .--.\0", "-.-. --- .-.\0", "-.-. --- ...\0", "-.-. --- -\0", "-.-. --- .--\0", "-.-. --- -..-\0", "-.-. --- -.--\0", "-.-. .-. -.--\0", "-.-. ..- -...\0", "-.-. ..- .\0", "-.-. ..- --\0", "-.-. ..- .--.\0", "-.-. ..- -\0", "-.. .- -...\0", "-.. .- -..\0", "-.. .- .-..\0", "-.. .- --\0", "-.. .- -.\0", "-.. .- -.--\0", "-.. . .\0", "-.. . ..-.\0", "-.. . .-..\0", "-.. . -.\0", "-.. . .--\0", "-.. .. -..\0", "-.. .. .\0", "-.. .. --.\0", "-.. .. --\0", "-.. .. -.\0", "-.. .. .--.\0", "-.. .. ...\0", "-.. --- -.-.\0", "-.. --- .\0", "-.. --- --.\0", "-.. --- -.\0", "-.. --- -\0", "-.. .-. -.--\0", "-.. ..- -...\0", "-.. ..- .\0", "-.. ..- --.\0", "-.. ..- -.\0", "-.. ..- ---\0", "-.. -.-- .\0", ". .- .-.\0", ". .- -\0", ". -... -...\0", ". -.-. ..-\0", ". ..-. -\0", ". --. --.\0", ". --. ---\0", ". .-.. ..-.\0", ". .-.. --\0", ". -- ..-\0", ". -. -..\0", ". .-. .-\0", ". - .-\0", ". ...- .\0", ". -.-- .\0", "..-. .- -...\0", "..-. .- -..\0", "..-. .- -.\0", "..-. .- .-.\0", "..-. .- -\0", "..-. .- -..-\0", "..-. .- -.--\0", "..-. . -..\0", "..-. . .\0", "..-. . -.\0", "..-. . .--\0", "..-. .. --.\0", "..-. .. -.\0", "..-. .. .-.\0", "..-. .. -\0", "..-. .. -..-\0", "..-. .-.. ..-\0", "..-. .-.. -.--\0", "..-. --- .\0", "..-. --- --.\0", "..-. --- .-.\0", "..-. --- -..-\0", "..-. .-. -.--\0", "..-. ..- -.\0", "..-. ..- .-.\0", "--. .- --.\0", "--. .- .-..\0", "--. .- .--.\0", "--. .- ...\0", "--. .- -.--\0", "--. . .\0", "--. . .-..\0", "--. . --\0", "--. . -\0", "--. .. --.\0", "--. .. -.\0", "--. --- -..\0", "--. --- -\0", "--. ..- --\0", "--. ..- -.\0", "--. ..- -\0", "--. ..- -.--\0", "--. -.-- --\0", ".... .- -..\0", ".... .- --\0", ".... .- ...\0", ".... .- -\0", ".... .- -.--\0", ".... . --\0", ".... . -.\0", ".... . .-.\0", ".... . -.--\0", ".... .. -..\0", ".... .. --\0", ".... .. .--.\0", ".... .. ...\0", ".... .. -\0", ".... --- --.\0", ".... --- -.\0", ".... --- .--.\0", ".... --- -\0", ".... --- .--\0", ".... ..- -...\0", ".... ..- .\0", ".... ..- --.\0", ".... ..- ....\0", ".... ..- --\0", ".... ..- -\0", ".. -.-. .\0", ".. -.-. -.--\0", ".. --. --.\0", ".. .-.. .-..\0", ".. -- .--.\0", ".. -. -.-\0", ".. -. -.\0", ".. --- -.\0", ".. - ...\0", ".. ...- -.--\0", ".--- .- --\0", ".--- .- .-.\0", ".--- .- .--\0", ".--- .- -.--\0", ".--- . -\0", ".--- . .--\0", ".--- --- -...\0", ".--- --- .\0", ".--- --- --.\0", ".--- --- -.--\0", ".--- ..- --.\0", ".--- ..- -.\0", "-.- .- -.--\0", "-.- . -.\0", "-.- . -.--\0", "-.- .. -..\0", "-.- .. -.\0", "-.- .. -\0", ".-.. .- -...\0", ".-.. .- -.-.\0", ".-.. .- -..\0", ".-.. .- --.\0", ".-.. .- --\0", ".-.. .- .--.\0", ".-.. .- .--\0", ".-.. .- -..-\0", ".-.. .- -.--\0", ".-.. . .-\0", ".-.. . -..\0", ".-.. . .\0", ".-.. . --.\0", ".-.. . ...\0", ".-.. . -\0", ".-.. .. -...\0", ".-.. .. -..\0", ".-.. .. .\0", ".-.. .. .--.\0", ".-.. .. -\0", ".-.. --- --.\0", ".-.. --- -\0", ".-.. --- .--\0", "-- .- -.-.\0", "-- .- -..\0", "-- .- --.\0", "-- .- -.\0", "-- .- .--.\0", "-- .- .-.\0", "-- .- ...\0", "-- .- -\0", "-- .- -..-\0", "-- .- -.--\0", "-- . -..\0", "-- . --.\0", "-- . -.\0", "-- . -\0", "-- .. -..\0", "-- .. .-..\0", "-- .. -..-\0", "-- --- -...\0", "-- --- -..\0", "-- --- .-..\0", "-- --- --\0", "-- --- -.\0", "-- --- .--.\0", "-- --- -\0", "-- ..- -..\0", "-- ..- --.\0", "-- ..- --\0", "-. .- -...\0", "-. .- ....\0", "-. .- -.\0", "-. .- .--.\0", "-. .- -.--\0", "-. . -...\0", "-. . --.\0", "-. . -\0", "-. . .--\0", "-. .. .-..\0", "-. .. .--.\0", "-. --- -..\0", "-. --- .-.\0", "-. --- ...\0", "-. --- -\0", "-. --- .--\0", "-. ..- -.\0", "-. ..- -\0", "--- .- -.-\0", "--- -.. -..\0", "--- ..-. ..-.\0", "--- ..-. -\0", "--- .. .-..\0", "--- .-.. -..\0", "--- .-.. .\0", "--- -. .\0", "--- --- ....\0", "--- .--. -\0", "--- .-. -...\0", "--- .-. .\0", "--- ..- .-.\0", "--- ..- -\0", "--- .-- .\0", "--- .-- .-..\0", "--- .-- -.\0", ".--. .- -.-.\0", ".--. .- -..\0", ".--. .- .-..\0", ".--. .- --\0", ".--. .- -.\0", ".--. .- .--.\0", ".--. .- .-.\0", ".--. .- ...\0", ".--. .- -\0", ".--. .- .--\0", ".--. .- -.--\0", ".--. . .-\0", ".--. . --.\0", ".--. . -.\0", ".--. . .--.\0", ".--. . .-.\0", ".--. . -\0", ".--. . .--\0", ".--. .... ..\0", ".--. .. -.-.\0", ".--. .. .\0", ".--. .. --.\0", ".--. .. -.\0", ".--. .. .--.\0", ".--. .. -\0", ".--. .-.. -.--\0", ".--. --- -..\0", ".--. --- .-..\0", ".--. --- .--.\0", ".--. --- -\0", ".--. .-. ---\0", ".--. ... ..\0", ".--. ..- -...\0", ".--. ..- .--.\0", ".--. ..- -\0", ".-. .- -..\0", ".-. .- --.\0", ".-. .- .---\0", ".-. .- --\0", ".-. .- -.\0", ".-. .- .--.\0", ".-. .- -\0", ".-. .- .--\0", ".-. .- -.--\0", ".-. . -..\0", ".-. . ..-.\0", ".-. . --.\0", ".-. . --\0", ".-. . .--.\0", ".-. . ...-\0", ".-. .. -...\0", ".-. .. -..\0", ".-. .. --.\0", ".-. .. --\0", ".-. .. .--.\0", ".-. --- -...\0", ".-. --- -..\0", ".-. --- .\0", ".-. --- -\0", ".-. --- .--\0", ".-. ..- -...\0", ".-. ..- .\0", ".-. ..- --.\0", ".-. ..- --\0", ".-. ..- -.\0", ".-. -.-- .\0", "... .- -...\0", "... .- -.-.\0", "... .- -..\0", "... .- .\0", "... .- --.\0", "... .- .-..\0", "... .- .--.\0", "... .- -\0", "... .- .--\0", "... .- -.--\0", "... . .-\0", "... . -.-.\0", "... . .\0", "... . -.\0", "... . -\0", "... . .--\0", "... . -..-\0", "... .... .\0", "... .... -.--\0", "... .. -.-.\0", "... .. --\0", "... .. -.\0", "... .. .--.\0", "... .. .-.\0", "... .. ...\0", "... .. -\0", "... .. -..-\0", "... -.- ..\0", "... -.- -.--\0", "... .-.. -.--\0", "... --- -..\0", "... --- .-..\0", "... --- -.\0", "... --- .--\0", "... --- -.--\0", "... .--. .-\0", "... .--. -.--\0", "... ..- -...\0", "... ..- .\0", "... ..- --\0", "... ..- -.\0", "... ..- .--.\0", "- .- -...\0", "- .- -..\0", "- .- --.\0", "- .- --\0", "- .- -.\0", "- .- .--.\0", "- .- .-.\0", "- .- -\0", "- .- -..-\0", "- . .-\0", "- . -..\0", "- . .\0", "- . -.\0", "- .... .\0", "- .... -.--\0", "- .. .\0", "- .. -.\0", "- .. .--.\0", "- --- -..\0", "- --- .\0", "- --- --\0", "- --- -.\0", "- --- ---\0", "- --- .--.\0", "- --- .-.\0", "- --- -\0", "- --- .--\0", "- --- -.--\0", "- .-. -.--\0", "- ..- -...\0", "- ..- --.\0", "- .-- ---\0", "..- ... .\0", "...- .- -.\0", "...- .- -\0", "...- . -\0", "...- .. .-\0", "...- .. .\0", "...- --- .--\0", ".-- .- -.\0", ".-- .- .-.\0", ".-- .- ...\0", ".-- .- -..-\0", ".-- .- -.--\0", ".-- . -...\0", ".-- . -..\0", ".-- . .\0", ".-- . -\0", ".-- .... ---\0", ".-- .... -.--\0", ".-- .. --.\0", ".-- .. -.\0", ".-- .. ...\0", ".-- .. -\0", ".-- --- -.\0", ".-- --- ---\0", ".-- --- .--\0", ".-- .-. -.--\0", ".-- -.-- .\0", "-.-- . -.\0", "-.-- . .--.\0", "-.-- . ...\0", "-.-- . -\0", "-.-- --- ..-\0", "--.. .. .--.\0", "--.. --- ---\0"};
+const char words[600][6] = {"ABA\0", "ABS\0", "ACE\0", "ACT\0", "ADD\0", "ADO\0", "AFT\0", "AGE\0", "AGO\0", "AHA\0", "AID\0", "AIM\0", "AIR\0", "ALA\0", "ALE\0", "ALL\0", "ALT\0", "AMP\0", "ANA\0", "AND\0", "ANT\0", "ANY\0", "APE\0", "APP\0", "APT\0", "ARC\0", "ARE\0", "ARK\0", "ARM\0", "ART\0", "ASH\0", "ASK\0", "ASP\0", "ASS\0", "ATE\0", "AVE\0", "AWE\0", "AXE\0", "AYE\0", "BAA\0", "BAD\0", "BAG\0", "BAN\0", "BAR\0", "BAT\0", "BAY\0", "BED\0", "BEE\0", "BEG\0", "BEL\0", "BEN\0", "BET\0", "BID\0", "BIG\0", "BIN\0", "BIO\0", "BIS\0", "BIT\0", "BIZ\0", "BOB\0", "BOG\0", "BOO\0", "BOW\0", "BOX\0", "BOY\0", "BRA\0", "BUD\0", "BUG\0", "BUM\0", "BUN\0", "BUS\0", "BUT\0", "BUY\0", "BYE\0", "CAB\0", "CAD\0", "CAM\0", "CAN\0", "CAP\0", "CAR\0", "CAT\0", "CHI\0", "COB\0", "COD\0", "COL\0", "CON\0", "COO\0", "COP\0", "COR\0", "COS\0", "COT\0", "COW\0", "COX\0", "COY\0", "CRY\0", "CUB\0", "CUE\0", "CUM\0", "CUP\0", "CUT\0", "DAB\0", "DAD\0", "DAL\0", "DAM\0", "DAN\0", "DAY\0", "DEE\0", "DEF\0", "DEL\0", "DEN\0", "DEW\0", "DID\0", "DIE\0", "DIG\0", "DIM\0", "DIN\0", "DIP\0", "DIS\0", "DOC\0", "DOE\0", "DOG\0", "DON\0", "DOT\0", "DRY\0", "DUB\0", "DUE\0", "DUG\0", "DUN\0", "DUO\0", "DYE\0", "EAR\0", "EAT\0", "EBB\0", "ECU\0", "EFT\0", "EGG\0", "EGO\0", "ELF\0", "ELM\0", "EMU\0", "END\0", "ERA\0", "ETA\0", "EVE\0", "EYE\0", "FAB\0", "FAD\0", "FAN\0", "FAR\0", "FAT\0", "FAX\0", "FAY\0", "FED\0", "FEE\0", "FEN\0", "FEW\0", "FIG\0", "FIN\0", "FIR\0", "FIT\0", "FIX\0", "FLU\0", "FLY\0", "FOE\0", "FOG\0", "FOR\0", "FOX\0", "FRY\0", "FUN\0", "FUR\0", "GAG\0", "GAL\0", "GAP\0", "GAS\0", "GAY\0", "GEE\0", "GEL\0", "GEM\0", "GET\0", "GIG\0", "GIN\0", "GOD\0", "GOT\0", "GUM\0", "GUN\0", "GUT\0", "GUY\0", "GYM\0", "HAD\0", "HAM\0", "HAS\0", "HAT\0", "HAY\0", "HEM\0", "HEN\0", "HER\0", "HEY\0", "HID\0", "HIM\0", "HIP\0", "HIS\0", "HIT\0", "HOG\0", "HON\0", "HOP\0", "HOT\0", "HOW\0", "HUB\0", "HUE\0", "HUG\0", "HUH\0", "HUM\0", "HUT\0", "ICE\0", "ICY\0", "IGG\0", "ILL\0", "IMP\0", "INK\0", "INN\0", "ION\0", "ITS\0", "IVY\0", "JAM\0", "JAR\0", "JAW\0", "JAY\0", "JET\0", "JEW\0", "JOB\0", "JOE\0", "JOG\0", "JOY\0", "JUG\0", "JUN\0", "KAY\0", "KEN\0", "KEY\0", "KID\0", "KIN\0", "KIT\0", "LAB\0", "LAC\0", "LAD\0", "LAG\0", "LAM\0", "LAP\0", "LAW\0", "LAX\0", "LAY\0", "LEA\0", "LED\0", "LEE\0", "LEG\0", "LES\0", "LET\0", "LIB\0", "LID\0", "LIE\0", "LIP\0", "LIT\0", "LOG\0", "LOT\0", "LOW\0", "MAC\0", "MAD\0", "MAG\0", "MAN\0", "MAP\0", "MAR\0", "MAS\0", "MAT\0", "MAX\0", "MAY\0", "MED\0", "MEG\0", "MEN\0", "MET\0", "MID\0", "MIL\0", "MIX\0", "MOB\0", "MOD\0", "MOL\0", "MOM\0", "MON\0", "MOP\0", "MOT\0", "MUD\0", "MUG\0", "MUM\0", "NAB\0", "NAH\0", "NAN\0", "NAP\0", "NAY\0", "NEB\0", "NEG\0", "NET\0", "NEW\0", "NIL\0", "NIP\0", "NOD\0", "NOR\0", "NOS\0", "NOT\0", "NOW\0", "NUN\0", "NUT\0", "OAK\0", "ODD\0", "OFF\0", "OFT\0", "OIL\0", "OLD\0", "OLE\0", "ONE\0", "OOH\0", "OPT\0", "ORB\0", "ORE\0", "OUR\0", "OUT\0", "OWE\0", "OWL\0", "OWN\0", "PAC\0", "PAD\0", "PAL\0", "PAM\0", "PAN\0", "PAP\0", "PAR\0", "PAS\0", "PAT\0", "PAW\0", "PAY\0", "PEA\0", "PEG\0", "PEN\0", "PEP\0", "PER\0", "PET\0", "PEW\0", "PHI\0", "PIC\0", "PIE\0", "PIG\0", "PIN\0", "PIP\0", "PIT\0", "PLY\0", "POD\0", "POL\0", "POP\0", "POT\0", "PRO\0", "PSI\0", "PUB\0", "PUP\0", "PUT\0", "RAD\0", "RAG\0", "RAJ\0", "RAM\0", "RAN\0", "RAP\0", "RAT\0", "RAW\0", "RAY\0", "RED\0", "REF\0", "REG\0", "REM\0", "REP\0", "REV\0", "RIB\0", "RID\0", "RIG\0", "RIM\0", "RIP\0", "ROB\0", "ROD\0", "ROE\0", "ROT\0", "ROW\0", "RUB\0", "RUE\0", "RUG\0", "RUM\0", "RUN\0", "RYE\0", "SAB\0", "SAC\0", "SAD\0", "SAE\0", "SAG\0", "SAL\0", "SAP\0", "SAT\0", "SAW\0", "SAY\0", "SEA\0", "SEC\0", "SEE\0", "SEN\0", "SET\0", "SEW\0", "SEX\0", "SHE\0", "SHY\0", "SIC\0", "SIM\0", "SIN\0", "SIP\0", "SIR\0", "SIS\0", "SIT\0", "SIX\0", "SKI\0", "SKY\0", "SLY\0", "SOD\0", "SOL\0", "SON\0", "SOW\0", "SOY\0", "SPA\0", "SPY\0", "SUB\0", "SUE\0", "SUM\0", "SUN\0", "SUP\0", "TAB\0", "TAD\0", "TAG\0", "TAM\0", "TAN\0", "TAP\0", "TAR\0", "TAT\0", "TAX\0", "TEA\0", "TED\0", "TEE\0", "TEN\0", "THE\0", "THY\0", "TIE\0", "TIN\0", "TIP\0", "TOD\0", "TOE\0", "TOM\0", "TON\0", "TOO\0", "TOP\0", "TOR\0", "TOT\0", "TOW\0", "TOY\0", "TRY\0", "TUB\0", "TUG\0", "TWO\0", "USE\0", "VAN\0", "VAT\0", "VET\0", "VIA\0", "VIE\0", "VOW\0", "WAN\0", "WAR\0", "WAS\0", "WAX\0", "WAY\0", "WEB\0", "WED\0", "WEE\0", "WET\0", "WHO\0", "WHY\0", "WIG\0", "WIN\0", "WIS\0", "WIT\0", "WON\0", "WOO\0", "WOW\0", "WRY\0", "WYE\0", "YEN\0", "YEP\0", "YES\0", "YET\0", "YOU\0", "ZIP\0", "ZOO\0"};
+const char morse[600][20] = {".- -... .-\0", ".- -... ...\0", ".- -.-. .\0", ".- -.-. -\0", ".- -.. -..\0", ".- -.. ---\0", ".- ..-. -\0", ".- --. .\0", ".- --. ---\0", ".- .... .-\0", ".- .. -..\0", ".- .. --\0", ".- .. .-.\0", ".- .-.. .-\0", ".- .-.. .\0", ".- .-.. .-..\0", ".- .-.. -\0", ".- -- .--.\0", ".- -. .-\0", ".- -. -..\0", ".- -. -\0", ".- -. -.--\0", ".- .--. .\0", ".- .--. .--.\0", ".- .--. -\0", ".- .-. -.-.\0", ".- .-. .\0", ".- .-. -.-\0", ".- .-. --\0", ".- .-. -\0", ".- ... ....\0", ".- ... -.-\0", ".- ... .--.\0", ".- ... ...\0", ".- - .\0", ".- ...- .\0", ".- .-- .\0", ".- -..- .\0", ".- -.-- .\0", "-... .- .-\0", "-... .- -..\0", "-... .- --.\0", "-... .- -.\0", "-... .- .-.\0", "-... .- -\0", "-... .- -.--\0", "-... . -..\0", "-... . .\0", "-... . --.\0", "-... . .-..\0", "-... . -.\0", "-... . -\0", "-... .. -..\0", "-... .. --.\0", "-... .. -.\0", "-... .. ---\0", "-... .. ...\0", "-... .. -\0", "-... .. --..\0", "-... --- -...\0", "-... --- --.\0", "-... --- ---\0", "-... --- .--\0", "-... --- -..-\0", "-... --- -.--\0", "-... .-. .-\0", "-... ..- -..\0", "-... ..- --.\0", "-... ..- --\0", "-... ..- -.\0", "-... ..- ...\0", "-... ..- -\0", "-... ..- -.--\0", "-... -.-- .\0", "-.-. .- -...\0", "-.-. .- -..\0", "-.-. .- --\0", "-.-. .- -.\0", "-.-. .- .--.\0", "-.-. .- .-.\0", "-.-. .- -\0", "-.-. .... ..\0", "-.-. --- -...\0", "-.-. --- -..\0", "-.-. --- .-..\0", "-.-. --- -.\0", "-.-. --- ---\0", "-.-. --- .--.\0", "-.-. --- .-.\0", "-.-. --- ...\0", "-.-. --- -\0", "-.-. --- .--\0", "-.-. --- -..-\0", "-.-. --- -.--\0", "-.-. .-. -.--\0", "-.-. ..- -...\0", "-.-. ..- .\0", "-.-. ..- --\0", "-.-. ..- .--.\0", "-.-. ..- -\0", "-.. .- -...\0", "-.. .- -..\0", "-.. .- .-..\0", "-.. .- --\0", "-.. .- -.\0", "-.. .- -.--\0", "-.. . .\0", "-.. . ..-.\0", "-.. . .-..\0", "-.. . -.\0", "-.. . .--\0", "-.. .. -..\0", "-.. .. .\0", "-.. .. --.\0", "-.. .. --\0", "-.. .. -.\0", "-.. .. .--.\0", "-.. .. ...\0", "-.. --- -.-.\0", "-.. --- .\0", "-.. --- --.\0", "-.. --- -.\0", "-.. --- -\0", "-.. .-. -.--\0", "-.. ..- -...\0", "-.. ..- .\0", "-.. ..- --.\0", "-.. ..- -.\0", "-.. ..- ---\0", "-.. -.-- .\0", ". .- .-.\0", ". .- -\0", ". -... -...\0", ". -.-. ..-\0", ". ..-. -\0", ". --. --.\0", ". --. ---\0", ". .-.. ..-.\0", ". .-.. --\0", ". -- ..-\0", ". -. -..\0", ". .-. .-\0", ". - .-\0", ". ...- .\0", ". -.-- .\0", "..-. .- -...\0", "..-. .- -..\0", "..-. .- -.\0", "..-. .- .-.\0", "..-. .- -\0", "..-. .- -..-\0", "..-. .- -.--\0", "..-. . -..\0", "..-. . .\0", "..-. . -.\0", "..-. . .--\0", "..-. .. --.\0", "..-. .. -.\0", "..-. .. .-.\0", "..-. .. -\0", "..-. .. -..-\0", "..-. .-.. ..-\0", "..-. .-.. -.--\0", "..-. --- .\0", "..-. --- --.\0", "..-. --- .-.\0", "..-. --- -..-\0", "..-. .-. -.--\0", "..-. ..- -.\0", "..-. ..- .-.\0", "--. .- --.\0", "--. .- .-..\0", "--. .- .--.\0", "--. .- ...\0", "--. .- -.--\0", "--. . .\0", "--. . .-..\0", "--. . --\0", "--. . -\0", "--. .. --.\0", "--. .. -.\0", "--. --- -..\0", "--. --- -\0", "--. ..- --\0", "--. ..- -.\0", "--. ..- -\0", "--. ..- -.--\0", "--. -.-- --\0", ".... .- -..\0", ".... .- --\0", ".... .- ...\0", ".... .- -\0", ".... .- -.--\0", ".... . --\0", ".... . -.\0", ".... . .-.\0", ".... . -.--\0", ".... .. -..\0", ".... .. --\0", ".... .. .--.\0", ".... .. ...\0", ".... .. -\0", ".... --- --.\0", ".... --- -.\0", ".... --- .--.\0", ".... --- -\0", ".... --- .--\0", ".... ..- -...\0", ".... ..- .\0", ".... ..- --.\0", ".... ..- ....\0", ".... ..- --\0", ".... ..- -\0", ".. -.-. .\0", ".. -.-. -.--\0", ".. --. --.\0", ".. .-.. .-..\0", ".. -- .--.\0", ".. -. -.-\0", ".. -. -.\0", ".. --- -.\0", ".. - ...\0", ".. ...- -.--\0", ".--- .- --\0", ".--- .- .-.\0", ".--- .- .--\0", ".--- .- -.--\0", ".--- . -\0", ".--- . .--\0", ".--- --- -...\0", ".--- --- .\0", ".--- --- --.\0", ".--- --- -.--\0", ".--- ..- --.\0", ".--- ..- -.\0", "-.- .- -.--\0", "-.- . -.\0", "-.- . -.--\0", "-.- .. -..\0", "-.- .. -.\0", "-.- .. -\0", ".-.. .- -...\0", ".-.. .- -.-.\0", ".-.. .- -..\0", ".-.. .- --.\0", ".-.. .- --\0", ".-.. .- .--.\0", ".-.. .- .--\0", ".-.. .- -..-\0", ".-.. .- -.--\0", ".-.. . .-\0", ".-.. . -..\0", ".-.. . .\0", ".-.. . --.\0", ".-.. . ...\0", ".-.. . -\0", ".-.. .. -...\0", ".-.. .. -..\0", ".-.. .. .\0", ".-.. .. .--.\0", ".-.. .. -\0", ".-.. --- --.\0", ".-.. --- -\0", ".-.. --- .--\0", "-- .- -.-.\0", "-- .- -..\0", "-- .- --.\0", "-- .- -.\0", "-- .- .--.\0", "-- .- .-.\0", "-- .- ...\0", "-- .- -\0", "-- .- -..-\0", "-- .- -.--\0", "-- . -..\0", "-- . --.\0", "-- . -.\0", "-- . -\0", "-- .. -..\0", "-- .. .-..\0", "-- .. -..-\0", "-- --- -...\0", "-- --- -..\0", "-- --- .-..\0", "-- --- --\0", "-- --- -.\0", "-- --- .--.\0", "-- --- -\0", "-- ..- -..\0", "-- ..- --.\0", "-- ..- --\0", "-. .- -...\0", "-. .- ....\0", "-. .- -.\0", "-. .- .--.\0", "-. .- -.--\0", "-. . -...\0", "-. . --.\0", "-. . -\0", "-. . .--\0", "-. .. .-..\0", "-. .. .--.\0", "-. --- -..\0", "-. --- .-.\0", "-. --- ...\0", "-. --- -\0", "-. --- .--\0", "-. ..- -.\0", "-. ..- -\0", "--- .- -.-\0", "--- -.. -..\0", "--- ..-. ..-.\0", "--- ..-. -\0", "--- .. .-..\0", "--- .-.. -..\0", "--- .-.. .\0", "--- -. .\0", "--- --- ....\0", "--- .--. -\0", "--- .-. -...\0", "--- .-. .\0", "--- ..- .-.\0", "--- ..- -\0", "--- .-- .\0", "--- .-- .-..\0", "--- .-- -.\0", ".--. .- -.-.\0", ".--. .- -..\0", ".--. .- .-..\0", ".--. .- --\0", ".--. .- -.\0", ".--. .- .--.\0", ".--. .- .-.\0", ".--. .- ...\0", ".--. .- -\0", ".--. .- .--\0", ".--. .- -.--\0", ".--. . .-\0", ".--. . --.\0", ".--. . -.\0", ".--. . .--.\0", ".--. . .-.\0", ".--. . -\0", ".--. . .--\0", ".--. .... ..\0", ".--. .. -.-.\0", ".--. .. .\0", ".--. .. --.\0", ".--. .. -.\0", ".--. .. .--.\0", ".--. .. -\0", ".--. .-.. -.--\0", ".--. --- -..\0", ".--. --- .-..\0", ".--. --- .--.\0", ".--. --- -\0", ".--. .-. ---\0", ".--. ... ..\0", ".--. ..- -...\0", ".--. ..- .--.\0", ".--. ..- -\0", ".-. .- -..\0", ".-. .- --.\0", ".-. .- .---\0", ".-. .- --\0", ".-. .- -.\0", ".-. .- .--.\0", ".-. .- -\0", ".-. .- .--\0", ".-. .- -.--\0", ".-. . -..\0", ".-. . ..-.\0", ".-. . --.\0", ".-. . --\0", ".-. . .--.\0", ".-. . ...-\0", ".-. .. -...\0", ".-. .. -..\0", ".-. .. --.\0", ".-. .. --\0", ".-. .. .--.\0", ".-. --- -...\0", ".-. --- -..\0", ".-. --- .\0", ".-. --- -\0", ".-. --- .--\0", ".-. ..- -...\0", ".-. ..- .\0", ".-. ..- --.\0", ".-. ..- --\0", ".-. ..- -.\0", ".-. -.-- .\0", "... .- -...\0", "... .- -.-.\0", "... .- -..\0", "... .- .\0", "... .- --.\0", "... .- .-..\0", "... .- .--.\0", "... .- -\0", "... .- .--\0", "... .- -.--\0", "... . .-\0", "... . -.-.\0", "... . .\0", "... . -.\0", "... . -\0", "... . .--\0", "... . -..-\0", "... .... .\0", "... .... -.--\0", "... .. -.-.\0", "... .. --\0", "... .. -.\0", "... .. .--.\0", "... .. .-.\0", "... .. ...\0", "... .. -\0", "... .. -..-\0", "... -.- ..\0", "... -.- -.--\0", "... .-.. -.--\0", "... --- -..\0", "... --- .-..\0", "... --- -.\0", "... --- .--\0", "... --- -.--\0", "... .--. .-\0", "... .--. -.--\0", "... ..- -...\0", "... ..- .\0", "... ..- --\0", "... ..- -.\0", "... ..- .--.\0", "- .- -...\0", "- .- -..\0", "- .- --.\0", "- .- --\0", "- .- -.\0", "- .- .--.\0", "- .- .-.\0", "- .- -\0", "- .- -..-\0", "- . .-\0", "- . -..\0", "- . .\0", "- . -.\0", "- .... .\0", "- .... -.--\0", "- .. .\0", "- .. -.\0", "- .. .--.\0", "- --- -..\0", "- --- .\0", "- --- --\0", "- --- -.\0", "- --- ---\0", "- --- .--.\0", "- --- .-.\0", "- --- -\0", "- --- .--\0", "- --- -.--\0", "- .-. -.--\0", "- ..- -...\0", "- ..- --.\0", "- .-- ---\0", "..- ... .\0", "...- .- -.\0", "...- .- -\0", "...- . -\0", "...- .. .-\0", "...- .. .\0", "...- --- .--\0", ".-- .- -.\0", ".-- .- .-.\0", ".-- .- ...\0", ".-- .- -..-\0", ".-- .- -.--\0", ".-- . -...\0", ".-- . -..\0", ".-- . .\0", ".-- . -\0", ".-- .... ---\0", ".-- .... -.--\0", ".-- .. --.\0", ".-- .. -.\0", ".-- .. ...\0", ".-- .. -\0", ".-- --- -.\0", ".-- --- ---\0", ".-- --- .--\0", ".-- .-. -.--\0", ".-- -.-- .\0", "-.-- . -.\0", "-.-- . .--.\0", "-.-- . ...\0", "-.-- . -\0", "-.-- --- ..-\0", "--.. .. .--.\0", "--.. --- ---\0"};
 
 //char morse[20][20] = {".... ..\0", "-.. --- --.\0", ".. -.-. .\0", ".-- --- .--\0", "-.. .- -.--\0"};
 
@@ -363,17 +374,10 @@ void choose_expected () {
 }
 
 void stats () {
-    // Print Statistics at the end of the level
-    float accuracy = correct;
-    accuracy *= 100.0;
-    accuracy /= attempts;
+    // Print Statistics at the end of the level (accuracy in tenths of a percent, no floats)
+    uint32_t accuracy = analytics_permille(correct, attempts);
     printf("█▓▒░ This level you had %d correct answer and %d incorrect answers.\n", correct, incorrect);
-    printf("█▓▒░ Your overall accuracy was ");
-    printf("%d", (int)accuracy);
-    printf(".");
-    accuracy = ((int)(accuracy)*10000) % 10000;
-    printf("%d", (int)accuracy);
-    printf("%% this level.\n█▓▒░\n");
+    printf("█▓▒░ Your overall accuracy was %u.%u%% this level.\n█▓▒░\n", accuracy / 10, accuracy % 10);
 }
 
 void print_expected () {
@@ -385,6 +389,9 @@ void print_expected () {
     else printf("\'%c\'", char_array[rand_num]);
     if (level % 2 == 1) printf(" and its morse code is \'%s\'\n", level > 2 ? morse[rand_num] : morse_table[rand_num]);
     else printf(".\n");
+
+    // Start timing the reaction to this question
+    analytics_prompt(level, level > 2 ? words[rand_num][0] : char_array[rand_num], time_us_32());
 }
 
 void level_init(int n) {
@@ -400,6 +407,23 @@ void level_init(int n) {
     lower_edge();
 }
 
+void retry_prompt () {
+    upper_edge();
+    print_expected();
+    lower_edge();
+}
+
+// Show the next prompt now, or once the cut-short word has been drained
+void show_prompt (void (*prompt)()) {
+    if (!draining) {
+        prompt();
+        return;
+    }
+
+    deferred_prompt = prompt;
+    printf("█▓▒░ Finish keying, the next question follows the pause.\n");
+}
+
 void state_processor (int size) {
     /*
         We can't have while loops,
@@ -412,6 +436,10 @@ void state_processor (int size) {
         calls and a bunch of global
         variables.
     */
+
+    // Input arrived before the deferred splash, don't let the splash wipe it out
+    splash_pending = false;
+
     switch (mode) {
         /*
             In Mode 0, any morse input
@@ -426,8 +454,22 @@ void state_processor (int size) {
 
             // Is it the right length?
             if (0 < size && size <= 2) {
+                // 5 and 6 are the analytics screens, they don't start a level
+                if (input[0] == 0x35) {
+                    clear_screen();
+                    upper_edge();
+                    analytics_screen();
+                    menu_screen();
+                    lower_edge();
+                } else if (input[0] == 0x36) {
+                    analytics_export();
+                    printf("\n█▓▒░ Exported %d bytes of analytics.\n\n", (int)sizeof(analytics_t));
+                } else if (input[0] == 0x37) {
+                    upper_edge();
+                    boot_report();
+                    lower_edge();
                 // Is it in the right Hex range? 1-4
-                if (0x30 < input[0] && input[0] <= 0x34) {
+                } else if (0x30 < input[0] && input[0] <= 0x34) {
                     clear_screen();
                     mode = 1;
 
@@ -462,7 +504,7 @@ void state_processor (int size) {
                     }
                 } else {
                     // Print Error
-                    printf("Make sure you enter a value between 1 and 4.\n\n");
+                    printf("Make sure you enter a value between 1 and 7.\n\n");
                 }
             } else {
                 // Print Error
@@ -500,6 +542,8 @@ void state_processor (int size) {
                             break;
                         } 
                     }
+
+                    analytics_answer(level, words[rand_num], input, draining);
                 } else {
                     if (size > 2) {
                         printf("Size: %d\n", size);
@@ -510,6 +554,9 @@ void state_processor (int size) {
                         printf("Got %c, expected %c.\n", input[0], char_array[rand_num]);
                         passed = false;
                     }
+
+                    char expected[2] = {char_array[rand_num], '\0'};
+                    analytics_answer(level, expected, input, draining);
                 }
 
                 // Check if passed test
@@ -560,13 +607,8 @@ void state_processor (int size) {
                     printf("█▓▒░ You have %d %s remaining.\n", lives, lives == 1 ? "life" : "lives");
                     lower_edge();
 
-                    if (lives <= 0) {
-                        losing_screen();
-                    } else {
-                        upper_edge();
-                        print_expected();
-                        lower_edge();
-                    }
+                    if (lives <= 0) show_prompt(losing_screen);
+                    else show_prompt(retry_prompt);
                 }
             }
 
@@ -616,8 +658,17 @@ void asm_gpio_set_irq(uint pin) {
 
 */
 
-// Function Call from ASM to add a Dot to the input buffer
-void add_dot () {
+// Function Call from ASM on every key-down, now_us is the press time stored in down_time
+void key_down (uint32_t now_us) {
+    boot_edge(now_us);
+    if (!draining) analytics_key_down(now_us);
+}
+
+// Function Call from ASM to add a Dot to the input buffer, hold_time is the press length in us
+void add_dot (uint32_t hold_time) {
+    if (draining) return;
+    analytics_element(mode == 1 ? level : 0, ANALYTICS_DOT, hold_time);
+
     // 0x2E is the Hex for the dot character in ASCII
     if (morse_index < MAX_MORSE_INPUT - 2) {
         morse_input[morse_index] = 0x2E;
@@ -628,8 +679,11 @@ void add_dot () {
 }
 
 
-// Function Call from ASM to add a Dash to the input buffer
-void add_dash () {
+// Function Call from ASM to add a Dash to the input buffer, hold_time is the press length in us
+void add_dash (uint32_t hold_time) {
+    if (draining) return;
+    analytics_element(mode == 1 ? level : 0, ANALYTICS_DASH, hold_time);
+
     // 0x2D is the Hex for the dash character in ASCII
     if (morse_index < MAX_MORSE_INPUT - 2) {
         morse_input[morse_index] = 0x2D;
@@ -639,8 +693,70 @@ void add_dash () {
     }
 }
 
+// Character and sequence gaps, these used to be ALARM0 and ALARM1
+deadline_t char_gap;
+deadline_t word_gap;
+
+static void char_gap_due (void *arg) {
+    end_char();
+}
+
+static void word_gap_due (void *arg) {
+    if (!draining) {
+        end_sequence();
+        return;
+    }
+
+    // The word that was cut short is finished, now the next question can be shown and answered
+    draining = false;
+    morse_index = 0;
+    input_index = 0;
+
+    if (deferred_prompt) {
+        void (*prompt)() = deferred_prompt;
+        deferred_prompt = NULL;
+        prompt();
+    }
+}
+
+// Function Call from ASM on every key release, schedules the end of the character and of the sequence
+void schedule_gaps (uint32_t now, uint32_t char_delay, uint32_t word_delay) {
+    scheduler_at(&char_gap, now + char_delay, char_gap_due, NULL);
+    scheduler_at(&word_gap, now + word_delay, word_gap_due, NULL);
+}
+
+// Function Call from ASM on every key press, the gaps start again from the next release
+void cancel_gaps () {
+    scheduler_cancel(&char_gap);
+    scheduler_cancel(&word_gap);
+}
+
+// Is the answer decidable from the characters committed so far?
+bool round_decided () {
+    // Level select only ever takes a single digit
+    if (mode == 0) return input_index > 0;
+
+    if (level > 2) return morse_match_prefix(input, input_index, words[rand_num]) != MATCH_PENDING;
+
+    char expected[2] = {char_array[rand_num], '\0'};
+    return morse_match_prefix(input, input_index, expected) != MATCH_PENDING;
+}
+
+// Has a word failed with letters still to key? Only then is there anything left to drain.
+bool round_cut_short () {
+    if (mode != 1 || level <= 2) return false;
+
+    const char *target = words[rand_num];
+    return morse_match_prefix(input, input_index, target) == MATCH_FAIL && input_index < (int)strlen(target);
+}
+
 // Function Call from ASM to end a morse sequence for a single character
 void end_char () {
+    if (draining) {
+        morse_index = 0;
+        return;
+    }
+
     if (morse_index < MAX_MORSE_INPUT - 1) {
         // Add NULL terminator to morse input string
         morse_input[morse_index] = 0x0;
@@ -653,6 +769,22 @@ void end_char () {
     }
 
     printf("%c", 0x20);
+
+    /*
+        Fail fast: end the round now if the answer is already decided,
+        rather than waiting for the sequence gap. Normally that's the
+        end of the input (a pass, a single character, a menu pick), so
+        word_gap is cancelled and the next answer is taken straight
+        away. A word that fails part way through is still being keyed,
+        so word_gap stays armed as a drain: every release pushes it
+        back, the rest of the word is thrown away, and the next prompt
+        is held back until it fires.
+    */
+    if (round_decided()) {
+        draining = round_cut_short();   // Set first so state_processor() knows to hold the prompt back
+        if (!draining) scheduler_cancel(&word_gap);
+        end_sequence();
+    }
 }
 
 
@@ -675,53 +807,46 @@ void end_sequence () {
 }
 
 void add_char () {
-    bool passed = true;
-
-    // Go through morse table to find our character
-    for (int i = 0; i < 36; i++) {
-        passed = true;
-        
-        // Go character by character
-        for (int j = 0; j < 6; j++) {
-            if (morse_input[j] != morse_table[i][j]) {
-                passed = false;
-                break;
-            }
-
-            if (morse_input[j] == '\0' || morse_table[i][j] == '\0') break;
-        }
-
-        if (passed) {
-            // If found the character, add to the input
-            if (morse_index < MAX_INPUT - 2) {
-                input[input_index] = char_array[i];
-                input_index++;
-            }
-
-            return;
-        }
-    }
-
-    // If we got here, it means we haven't found our character, so add a '?' (0x3F in Hex).
-    if (morse_index < MAX_INPUT - 2) {
-        input[input_index] = 0x3F;
+    // Go through morse table to find our character, '?' if it isn't there
+    if (input_index < MAX_INPUT - 2) {
+        input[input_index] = morse_lookup(morse_input);
         input_index++;
     }
+}
+
+// Function Call from the ASM main loop, draws the deferred welcome screen once
+void splash_poll () {
+    if (!splash_pending) return;
+    splash_pending = false;
 
-    return;
+    if (boot_fast()) quick_welcome_screen();
+    else welcome_screen();
+
+    boot_mark(BOOT_SPLASH);
 }
 
 /*
-    Main entry point for the code - simply calls the main assembly function.
+    Main entry point for the code. Key capture is installed first so
+    presses made while the rest of the board comes up are
+    buffered, then the slower setup runs and the main assembly loop
+    takes over.
 */
 int main() {
-    stdio_init_all();              // Initialise all basic IO
+    boot_mark(BOOT_MAIN);
+
+    scheduler_init();
+    capture_init();                // GP21 + ISRs, see assign02.S
+    boot_mark(BOOT_CAPTURE);
 
     // Initialise the PIO interface with the WS2812 code
     PIO pio = pio0;
     uint offset = pio_add_program(pio, &ws2812_program);
     ws2812_program_init(pio, 0, offset, WS2812_PIN, 800000, IS_RGBW);
     wd_enable();
+    boot_mark(BOOT_LED);
+
+    stdio_init_all();              // Initialise all basic IO
+    boot_mark(BOOT_STDIO);
 
     main_asm();
     return 0;
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+#include "boot.h"
+
+static uint32_t boot_times[BOOT_STAGES];
+static volatile bool boot_seen[BOOT_STAGES];   // One flag per stage so the ISR and main never share a word
+
+static const char *boot_names[BOOT_STAGES] = {
+    "main() entered",
+    "key capture ready",
+    "LED + watchdog ready",
+    "stdio ready",
+    "splash drawn",
+    "first key-down",
+};
+
+// Stamp a stage, only the first time it is reached counts
+void boot_mark(boot_stage_t stage) {
+    if (boot_reached(stage)) return;
+    boot_times[stage] = time_us_32();
+    boot_seen[stage] = true;
+}
+
+// Called from the GPIO ISR with the press time it already read from TIMELR
+void boot_edge(uint32_t now_us) {
+    if (boot_reached(BOOT_FIRST_EDGE)) return;
+    boot_times[BOOT_FIRST_EDGE] = now_us;
+    boot_seen[BOOT_FIRST_EDGE] = true;
+}
+
+bool boot_reached(boot_stage_t stage) {
+    return boot_seen[stage];
+}
+
+uint32_t boot_time(boot_stage_t stage) {
+    return boot_times[stage];
+}
+
+// A watchdog reset takes the fast path: the operator is mid-session and doesn't need the banners again
+bool boot_fast() {
+    return watchdog_caused_reboot();
+}
+
+// Print every stage reached, relative to timer start and to the previous stage
+void boot_report() {
+    uint32_t prev = 0;
+
+    printf("█▓▒░ BOOT TIMELINE (%s boot)\n", boot_fast() ? "fast" : "cold");
+    for (int s = 0; s < BOOT_STAGES; s++) {
+        if (!boot_reached(s)) {
+            printf("█▓▒░   %-22s  not reached\n", boot_names[s]);
+            continue;
+        }
+        printf("█▓▒░   %-22s %9uus  (%+dus)\n", boot_names[s], boot_times[s], (int32_t)(boot_times[s] - prev));
+        prev = boot_times[s];
+    }
+
+    uint32_t ready = boot_times[BOOT_CAPTURE];
+    printf("█▓▒░ Timer-start-to-ready %uus, budget %uus: %s\n", ready, BOOT_READY_BUDGET_US,
+           ready <= BOOT_READY_BUDGET_US ? "OK" : "OVER BUDGET");
+}
@@ -0,0 +1,36 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Boot Timeline
+
+    Each stage of start-up is stamped with the microsecond timer.
+    runtime_init() resets and restarts TIMER after crt0 has copied
+    .data and cleared .bss, so the stamps count from timer start, not
+    from reset: they cover runtime init and main(), but not the crt0
+    copy before it.
+*/
+
+typedef enum {
+    BOOT_MAIN = 0,          // main() entered (runtime init done)
+    BOOT_CAPTURE,           // GP21 and the ISRs installed, presses are captured from here on
+    BOOT_LED,               // WS2812 PIO program loaded, watchdog running
+    BOOT_STDIO,             // stdio_init_all() returned
+    BOOT_SPLASH,            // Welcome screen drawn
+    BOOT_FIRST_EDGE,        // First key-down seen by the GPIO ISR
+    BOOT_STAGES
+} boot_stage_t;
+
+#define BOOT_READY_BUDGET_US    50000       // Timer start to BOOT_CAPTURE must stay under 50ms
+
+void boot_mark(boot_stage_t stage);
+void boot_edge(uint32_t now_us);
+bool boot_reached(boot_stage_t stage);
+uint32_t boot_time(boot_stage_t stage);
+bool boot_fast();
+void boot_report();
+
+#endif
@@ -0,0 +1,132 @@
+#include <string.h>
+#include "morse_decoder.h"
+
+const char char_array[MORSE_CHARS] = {
+    // Digits 0 - 9
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+    // Letters A - Z
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'};
+const char morse_table[MORSE_CHARS][6] = { // Must declare as a char pointer array to get an array of strings since this is in C not C++
+    // Digits 0 - 9
+    "-----\0", ".----\0", "..---\0", "...--\0", "....-\0", ".....\0",
+    "-....\0", "--...\0", "---..\0", "----.\0",
+    // Letters A - Z
+    ".-\0", "-...\0", "-.-.\0", "-..\0", ".\0", "..-.\0", "--.\0", "....\0",
+    "..\0", ".---\0", "-.-\0", ".-..\0", "--\0", "-.\0", "---\0", ".--.\0",
+    "--.-\0", ".-.\0", "...\0", "-\0", "..-\0", "...-\0", ".--\0", "-..-\0",
+    "-.--\0", "--..\0",
+};
+
+// Find the character for a NULL terminated dot/dash string, '?' (0x3F) if there isn't one
+char morse_lookup(const char *morse) {
+    for (int i = 0; i < MORSE_CHARS; i++) {
+        if (strcmp(morse, morse_table[i]) == 0) return char_array[i];
+    }
+    return 0x3F;
+}
+
+// Compare the first len characters of input against target, decidable as soon as they differ or match fully
+morse_match_t morse_match_prefix(const char *input, int len, const char *target) {
+    for (int j = 0; j < len; j++) {
+        if (target[j] == '\0' || input[j] != target[j]) return MATCH_FAIL;
+    }
+    return target[len] == '\0' ? MATCH_PASS : MATCH_PENDING;
+}
+
+void morse_decoder_init(morse_decoder_t *d, const morse_timing_t *timing, morse_sequence_cb on_sequence, void *user) {
+    memset(d, 0, sizeof(*d));
+    if (timing) {
+        d->timing = *timing;
+    } else {
+        d->timing.dot_time = MORSE_DOT_TIME;
+        d->timing.char_gap = MORSE_CHAR_GAP;
+        d->timing.word_gap = MORSE_WORD_GAP;
+    }
+    d->on_sequence = on_sequence;
+    d->user = user;
+}
+
+static void add_element(morse_decoder_t *d, char element) {
+    if (d->morse_index < MORSE_MAX_ELEMENTS - 2) {
+        d->morse_input[d->morse_index] = element;
+        d->morse_index++;
+    }
+}
+
+void morse_decoder_add_dot(morse_decoder_t *d) {
+    add_element(d, 0x2E);
+    d->dots++;
+}
+
+void morse_decoder_add_dash(morse_decoder_t *d) {
+    add_element(d, 0x2D);
+    d->dashes++;
+}
+
+// Same as end_char() + add_char() in assign02.c
+void morse_decoder_end_char(morse_decoder_t *d) {
+    d->morse_input[d->morse_index] = 0x0;
+    d->morse_index = 0;
+
+    char c = morse_lookup(d->morse_input);
+    if (c == 0x3F) d->unknown++;
+    d->chars++;
+
+    if (d->input_index < MORSE_MAX_INPUT - 2) {
+        d->input[d->input_index] = c;
+        d->input_index++;
+    }
+}
+
+// Same as end_sequence() in assign02.c, hands the finished input to the callback
+void morse_decoder_end_sequence(morse_decoder_t *d, uint32_t t_us) {
+    d->input[d->input_index] = 0x0;
+    if (d->on_sequence) d->on_sequence(d, d->input, t_us);
+
+    d->input_index = 0;
+    d->morse_index = 0;
+}
+
+// Fire the character / sequence gaps if their deadlines have passed by t_us
+void morse_decoder_advance(morse_decoder_t *d, uint32_t t_us) {
+    if (d->char_armed && (int32_t)(t_us - (d->up_time + d->timing.char_gap)) >= 0) {
+        d->char_armed = false;
+        morse_decoder_end_char(d);
+        if (d->on_char) d->on_char(d, d->input[d->input_index - 1], d->up_time + d->timing.char_gap);
+    }
+    if (d->seq_armed && (int32_t)(t_us - (d->up_time + d->timing.word_gap)) >= 0) {
+        d->seq_armed = false;
+        morse_decoder_end_sequence(d, d->up_time + d->timing.word_gap);
+    }
+}
+
+// Feed one key edge, exactly what the GPIO ISR does on the falling / rising edge of GP21
+void morse_decoder_key(morse_decoder_t *d, bool down, uint32_t t_us) {
+    morse_decoder_advance(d, t_us);
+    if (down == d->key_down) return;
+    d->key_down = down;
+
+    if (down) {
+        // Pressed: disable both alarms and remember the press time
+        d->char_armed = false;
+        d->seq_armed = false;
+        d->down_time = t_us;
+        if (d->input_index == 0 && d->morse_index == 0) d->seq_start = t_us;
+        return;
+    }
+
+    // Released: classify the hold and re-arm both alarms
+    if (t_us - d->down_time <= d->timing.dot_time) morse_decoder_add_dot(d);
+    else morse_decoder_add_dash(d);
+
+    d->up_time = t_us;
+    d->char_armed = true;
+    d->seq_armed = true;
+}
+
+// End of the input stream, let any pending alarms fire
+void morse_decoder_flush(morse_decoder_t *d, uint32_t t_us) {
+    if (d->key_down) morse_decoder_key(d, false, t_us);
+    morse_decoder_advance(d, d->up_time + d->timing.word_gap);
+    if (d->input_index > 0) morse_decoder_end_sequence(d, t_us);
+}
@@ -0,0 +1,86 @@
+#ifndef MORSE_DECODER_H
+#define MORSE_DECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "morse_timing.h"
+
+/*
+    Morse Decoder
+
+    The character tables and morse_lookup() are used by the firmware
+    as well as the host tools. The morse_decoder_t side is a host
+    model of the device's dot/dash/char/sequence logic with its state
+    held in a struct instead of globals, so tools can run many
+    decoders at once. The firmware still runs its own copy in
+    assign02.c, so changes there (such as the fail-fast round check)
+    are not picked up here. The default timings come from
+    morse_timing.h, the same header assign02.S takes them from.
+    Nothing in here depends on the Pico SDK.
+*/
+
+#define MORSE_MAX_ELEMENTS  20          // Same as MAX_MORSE_INPUT
+#define MORSE_MAX_INPUT     200         // Same as MAX_INPUT
+#define MORSE_CHARS         36
+
+// Digits 0 - 9 then Letters A - Z, with the morse sequence for each
+extern const char char_array[MORSE_CHARS];
+extern const char morse_table[MORSE_CHARS][6];
+
+typedef struct {
+    uint32_t dot_time;
+    uint32_t char_gap;
+    uint32_t word_gap;
+} morse_timing_t;
+
+// Result of checking a partial answer against its target
+typedef enum {
+    MATCH_PENDING = 0,      // Input so far is a prefix of the target, keep going
+    MATCH_PASS,             // Input is exactly the target
+    MATCH_FAIL,             // Input can no longer become the target
+} morse_match_t;
+
+struct morse_decoder;
+typedef void (*morse_sequence_cb)(struct morse_decoder *d, const char *text, uint32_t t_us);
+typedef void (*morse_char_cb)(struct morse_decoder *d, char c, uint32_t t_us);
+
+typedef struct morse_decoder {
+    morse_timing_t timing;
+
+    // Input buffers, exactly like morse_input / input in assign02.c
+    char morse_input[MORSE_MAX_ELEMENTS];
+    int  morse_index;
+    char input[MORSE_MAX_INPUT];
+    int  input_index;
+
+    // Key edge state used to emulate the GPIO ISR and the gap deadlines
+    bool     key_down;
+    bool     char_armed;        // Character gap pending
+    bool     seq_armed;         // Sequence gap pending
+    uint32_t down_time;
+    uint32_t up_time;
+    uint32_t seq_start;         // First key-down of the current sequence
+
+    // Statistics
+    uint32_t dots;
+    uint32_t dashes;
+    uint32_t chars;
+    uint32_t unknown;           // Characters decoded as '?'
+
+    morse_sequence_cb on_sequence;
+    morse_char_cb on_char;      // Optional, called when the character gap commits a character
+    void *user;
+} morse_decoder_t;
+
+char morse_lookup(const char *morse);
+morse_match_t morse_match_prefix(const char *input, int len, const char *target);
+void morse_decoder_init(morse_decoder_t *d, const morse_timing_t *timing, morse_sequence_cb on_sequence, void *user);
+void morse_decoder_add_dot(morse_decoder_t *d);
+void morse_decoder_add_dash(morse_decoder_t *d);
+void morse_decoder_end_char(morse_decoder_t *d);
+void morse_decoder_end_sequence(morse_decoder_t *d, uint32_t t_us);
+void morse_decoder_key(morse_decoder_t *d, bool down, uint32_t t_us);
+void morse_decoder_advance(morse_decoder_t *d, uint32_t t_us);
+void morse_decoder_flush(morse_decoder_t *d, uint32_t t_us);
+
+#endif
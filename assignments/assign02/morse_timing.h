@@ -0,0 +1,17 @@
+#ifndef MORSE_TIMING_H
+#define MORSE_TIMING_H
+
+/*
+    Morse Timing
+
+    The game's key timings in microseconds, the one place they are set.
+    Macros only, with no C in here, so that assign02.S can include it
+    through the C preprocessor as well as the C code and host tools.
+    Powers of two, so the timer compares stay simple.
+*/
+
+#define MORSE_DOT_TIME      0x00030000  // Hold time <= this is a dot          0.196608 seconds
+#define MORSE_CHAR_GAP      0x00180000  // Silence that ends a char            1.572864 seconds
+#define MORSE_WORD_GAP      0x00300000  // Silence that ends a sequence        3.145728 seconds
+
+#endif
@@ -0,0 +1,59 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "scheduler.h"
+
+#define SCHED_ALARM     0
+#define SCHED_MASK      (1u << SCHED_ALARM)
+
+static timer_wheel_t wheel;
+
+// Point ALARM0 at the earliest deadline, or switch it off if there is none
+static void reprogram() {
+    uint32_t when;
+    if (!wheel_next(&wheel, time_us_32(), &when)) {
+        hw_clear_bits(&timer_hw->inte, SCHED_MASK);
+        timer_hw->armed = SCHED_MASK;                   // Writing 1 disarms
+        return;
+    }
+
+    timer_hw->alarm[SCHED_ALARM] = when;
+    hw_set_bits(&timer_hw->inte, SCHED_MASK);
+
+    // The alarm only matches on equality, so a deadline that has already passed is forced instead
+    if ((int32_t)(when - time_us_32()) <= 0) hw_set_bits(&timer_hw->intf, SCHED_MASK);
+}
+
+void scheduler_init() {
+    wheel_init(&wheel, time_us_32());
+    hw_clear_bits(&timer_hw->inte, SCHED_MASK);
+}
+
+void scheduler_at(deadline_t *d, uint32_t when, deadline_cb fn, void *arg) {
+    uint32_t irq = save_and_disable_interrupts();
+
+    // An empty wheel can start its lap from now, keeping wheel_next()'s walk short
+    if (wheel.pending == 0) wheel.last_run = time_us_32();
+
+    wheel_insert(&wheel, d, when, fn, arg);
+    reprogram();
+    restore_interrupts(irq);
+}
+
+void scheduler_in(deadline_t *d, uint32_t delay_us, deadline_cb fn, void *arg) {
+    scheduler_at(d, time_us_32() + delay_us, fn, arg);
+}
+
+void scheduler_cancel(deadline_t *d) {
+    uint32_t irq = save_and_disable_interrupts();
+    wheel_cancel(&wheel, d);
+    reprogram();
+    restore_interrupts(irq);
+}
+
+// Function Call from the ALARM0 ISR in ASM (after it has cleared the raw interrupt)
+void scheduler_run() {
+    hw_clear_bits(&timer_hw->intf, SCHED_MASK);
+    wheel_run(&wheel, time_us_32());
+    reprogram();
+}
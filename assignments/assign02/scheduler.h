@@ -0,0 +1,21 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "timer_wheel.h"
+
+/*
+    Deadline Scheduler
+
+    All timed work shares ALARM0: the timer wheel holds the deadlines
+    and ALARM0 is always programmed for the earliest one. ALARM1-3 are
+    left free. Safe to call from the GPIO / ALARM ISRs and from the
+    main loop.
+*/
+
+void scheduler_init();
+void scheduler_at(deadline_t *d, uint32_t when, deadline_cb fn, void *arg);
+void scheduler_in(deadline_t *d, uint32_t delay_us, deadline_cb fn, void *arg);
+void scheduler_cancel(deadline_t *d);
+void scheduler_run();
+
+#endif
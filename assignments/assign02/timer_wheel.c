@@ -0,0 +1,123 @@
+#include <stddef.h>
+#include "timer_wheel.h"
+
+#define TICK_MASK   ((1u << (32 - WHEEL_SHIFT)) - 1)    // Slot ticks are 32 - WHEEL_SHIFT bits wide, they wrap with the clock
+
+static inline uint32_t slot_of(uint32_t t) {
+    return (t >> WHEEL_SHIFT) & WHEEL_MASK;
+}
+
+static inline bool is_due(uint32_t when, uint32_t now) {
+    return (int32_t)(now - when) >= 0;
+}
+
+void wheel_init(timer_wheel_t *w, uint32_t now) {
+    for (int s = 0; s < WHEEL_SLOTS; s++) w->slots[s] = NULL;
+    for (int i = 0; i < WHEEL_WORDS; i++) w->occupied[i] = 0;
+    w->last_run = now;
+    w->pending = 0;
+}
+
+// Add (or move) a deadline, O(1)
+void wheel_insert(timer_wheel_t *w, deadline_t *d, uint32_t when, deadline_cb fn, void *arg) {
+    if (d->armed) wheel_cancel(w, d);
+
+    d->when = when;
+    d->fn = fn;
+    d->arg = arg;
+    d->armed = true;
+
+    // Already overdue: file it where the next run starts looking so it isn't a lap late
+    uint32_t s = is_due(when, w->last_run) ? slot_of(w->last_run) : slot_of(when);
+
+    d->slot = (uint16_t)s;
+    d->prev = NULL;
+    d->next = w->slots[s];
+    if (d->next) d->next->prev = d;
+    w->slots[s] = d;
+    w->occupied[s >> 5] |= 1u << (s & 31);
+    w->pending++;
+}
+
+// Remove a deadline if it is armed, O(1)
+void wheel_cancel(timer_wheel_t *w, deadline_t *d) {
+    if (!d->armed) return;
+    d->armed = false;
+
+    if (d->prev) {
+        d->prev->next = d->next;
+    } else {
+        w->slots[d->slot] = d->next;
+        if (!d->next) w->occupied[d->slot >> 5] &= ~(1u << (d->slot & 31));
+    }
+    if (d->next) d->next->prev = d->prev;
+
+    d->next = d->prev = NULL;
+    w->pending--;
+}
+
+/*
+    Earliest pending deadline. Slots are walked in time order from the
+    last run using the occupancy bitmap; the first slot holding an
+    entry for this lap (or an overdue one) has the answer.
+*/
+static deadline_t *earliest(const timer_wheel_t *w, uint32_t now) {
+    if (w->pending == 0) return NULL;
+
+    uint32_t base = w->last_run >> WHEEL_SHIFT;
+    for (uint32_t k = 0; k < WHEEL_SLOTS;) {
+        uint32_t s = (base + k) & WHEEL_MASK;
+        uint32_t bits = w->occupied[s >> 5] >> (s & 31);
+        if (bits == 0) {
+            k += 32 - (s & 31);
+            continue;
+        }
+        k += __builtin_ctz(bits);
+        s = (base + k) & WHEEL_MASK;
+
+        deadline_t *best = NULL;
+        for (deadline_t *d = w->slots[s]; d; d = d->next) {
+            bool this_lap = (((d->when >> WHEEL_SHIFT) - base) & TICK_MASK) == k || is_due(d->when, now);
+            if (this_lap && (!best || (int32_t)(d->when - best->when) < 0)) best = d;
+        }
+        if (best) return best;
+        k++;
+    }
+
+    // Everything is more than a lap away, fall back to the plain minimum
+    deadline_t *best = NULL;
+    for (int s = 0; s < WHEEL_SLOTS; s++) {
+        for (deadline_t *d = w->slots[s]; d; d = d->next) {
+            if (!best || (int32_t)(d->when - best->when) < 0) best = d;
+        }
+    }
+    return best;
+}
+
+bool wheel_next(const timer_wheel_t *w, uint32_t now, uint32_t *when) {
+    const deadline_t *d = earliest(w, now);
+    if (d) *when = d->when;
+    return d != NULL;
+}
+
+/*
+    Fire every deadline that is due by now, earliest first. Returns how
+    many fired. Each one is taken off the wheel just before its callback
+    runs and nothing else is detached, so a callback can cancel, move or
+    insert any other deadline, including ones due in this same run.
+*/
+int wheel_run(timer_wheel_t *w, uint32_t now) {
+    int fired = 0;
+    deadline_t *d;
+
+    while ((d = earliest(w, now)) && is_due(d->when, now)) {
+        // Overdue inserts made by the callback are filed from here, so the next walk still finds them
+        if (!is_due(d->when, w->last_run)) w->last_run = d->when;
+
+        wheel_cancel(w, d);
+        d->fn(d->arg);
+        fired++;
+    }
+    w->last_run = now;
+    return fired;
+}
@@ -0,0 +1,52 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Timer Wheel
+
+    Deadlines hashed into WHEEL_SLOTS buckets of 2^WHEEL_SHIFT us by
+    their absolute 32-bit microsecond time, each bucket an intrusive
+    doubly linked list. Insert and cancel are O(1) and never allocate;
+    the caller owns every deadline_t. A bitmap of non-empty buckets
+    lets the next deadline be found with a handful of word scans, so
+    a single hardware alarm can be programmed for it.
+
+    Deadlines further out than one lap (WHEEL_SLOTS << WHEEL_SHIFT us)
+    are fine, they just stay in their bucket until they come due.
+    Nothing in here depends on the Pico SDK.
+*/
+
+#define WHEEL_SHIFT     14                          // 16.384 ms per slot
+#define WHEEL_SLOTS     256                         // 4.194304 seconds per lap
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+#define WHEEL_WORDS     (WHEEL_SLOTS / 32)
+
+typedef void (*deadline_cb)(void *arg);
+
+typedef struct deadline {
+    struct deadline *next;
+    struct deadline *prev;
+    uint32_t when;              // Absolute time in us
+    deadline_cb fn;
+    void *arg;
+    uint16_t slot;              // Where it was filed
+    bool armed;
+} deadline_t;
+
+typedef struct {
+    deadline_t *slots[WHEEL_SLOTS];
+    uint32_t occupied[WHEEL_WORDS];     // Bit set when the slot's list is non-empty
+    uint32_t last_run;                  // Time of the previous wheel_run()
+    uint32_t pending;
+} timer_wheel_t;
+
+void wheel_init(timer_wheel_t *w, uint32_t now);
+void wheel_insert(timer_wheel_t *w, deadline_t *d, uint32_t when, deadline_cb fn, void *arg);
+void wheel_cancel(timer_wheel_t *w, deadline_t *d);
+bool wheel_next(const timer_wheel_t *w, uint32_t now, uint32_t *when);
+int  wheel_run(timer_wheel_t *w, uint32_t now);
+
+#endif
@@ -0,0 +1,454 @@
+/*
+    Batch Decoder
+
+    Decodes large numbers of recorded key traces (.trace / text) and
+    CW recordings (16-bit PCM .wav) with the same dot/dash/char/sequence
+    logic as the game, to tune the timing thresholds offline.
+
+    Every worker thread owns its own morse_decoder_t and output buffer,
+    files are read through mmap, and work is balanced with per-worker
+    queues that idle workers steal from. Results are written to a single
+    tab separated report in input order as soon as each one is ready.
+
+    If "<file>.expected" exists, its text is compared with the decode
+    and the accuracy (tenths of a percent, edit distance based) is
+    reported alongside.
+*/
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "key_events.h"
+#include "mapped_file.h"
+#include "morse_decoder.h"
+#include "wav.h"
+
+/* ---Growable string--- */
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} strbuf_t;
+
+static void sb_reserve(strbuf_t *s, size_t extra) {
+    if (s->len + extra + 1 <= s->cap) return;
+    size_t cap = s->cap ? s->cap : 256;
+    while (cap < s->len + extra + 1) cap *= 2;
+    s->data = realloc(s->data, cap);
+    if (!s->data) {
+        perror("realloc");
+        exit(1);
+    }
+    s->cap = cap;
+}
+
+static void sb_append(strbuf_t *s, const char *str, size_t n) {
+    sb_reserve(s, n);
+    memcpy(s->data + s->len, str, n);
+    s->len += n;
+    s->data[s->len] = '\0';
+}
+
+__attribute__((format(printf, 2, 3)))
+static void sb_printf(strbuf_t *s, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+
+    sb_reserve(s, (size_t)n);
+    va_start(ap, fmt);
+    vsnprintf(s->data + s->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    s->len += (size_t)n;
+}
+
+/* ---Work stealing queues--- */
+
+typedef struct {
+    pthread_mutex_t lock;
+    size_t *items;
+    size_t head;                // Owner takes from the head (keeps output roughly in order)
+    size_t tail;                // Thieves take from the tail
+} work_queue_t;
+
+static bool queue_take(work_queue_t *q, size_t *item) {
+    bool ok = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail) {
+        *item = q->items[q->head++];
+        ok = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+static bool queue_steal(work_queue_t *q, size_t *item) {
+    bool ok = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail) {
+        *item = q->items[--q->tail];
+        ok = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+/* ---Batch state--- */
+
+typedef struct {
+    bool done;
+    char *line;
+    size_t len;
+} result_t;
+
+typedef struct {
+    // Inputs
+    char **paths;
+    size_t count;
+    morse_timing_t timing;
+
+    // Workers
+    int threads;
+    work_queue_t *queues;
+
+    // Ordered, streamed report
+    pthread_mutex_t report_lock;
+    FILE *report;
+    result_t *results;
+    size_t next_emit;
+
+    // Totals, only updated under report_lock
+    uint64_t bytes;
+    uint64_t chars;
+    uint64_t expected_chars;
+    uint64_t expected_errors;
+    size_t failed;
+} batch_t;
+
+typedef struct {
+    batch_t *batch;
+    int id;
+    uint32_t rng;
+    morse_decoder_t decoder;    // One decoder context per worker
+    strbuf_t text;
+    strbuf_t line;
+} worker_t;
+
+// Collect each finished sequence as a word
+static void on_sequence(morse_decoder_t *d, const char *text, uint32_t t_us) {
+    strbuf_t *s = d->user;
+    if (text[0] == '\0') return;
+    if (s->len > 0) sb_append(s, " ", 1);
+    sb_append(s, text, strlen(text));
+}
+
+// Upper case and collapse whitespace so expected files can be written loosely
+static void normalise(strbuf_t *out, const uint8_t *data, size_t size) {
+    bool space = false;
+    out->len = 0;
+    sb_reserve(out, size);
+    for (size_t i = 0; i < size; i++) {
+        if (isspace(data[i])) {
+            space = out->len > 0;
+            continue;
+        }
+        if (space) out->data[out->len++] = ' ';
+        space = false;
+        out->data[out->len++] = (char)toupper(data[i]);
+    }
+    out->data[out->len] = '\0';
+}
+
+// Levenshtein distance with two rows
+static size_t edit_distance(const char *a, size_t n, const char *b, size_t m) {
+    size_t *prev = malloc((m + 1) * sizeof(size_t));
+    size_t *cur = malloc((m + 1) * sizeof(size_t));
+    for (size_t j = 0; j <= m; j++) prev[j] = j;
+
+    for (size_t i = 1; i <= n; i++) {
+        cur[0] = i;
+        for (size_t j = 1; j <= m; j++) {
+            size_t best = prev[j - 1] + (a[i - 1] != b[j - 1]);
+            if (prev[j] + 1 < best) best = prev[j] + 1;
+            if (cur[j - 1] + 1 < best) best = cur[j - 1] + 1;
+            cur[j] = best;
+        }
+        size_t *t = prev;
+        prev = cur;
+        cur = t;
+    }
+
+    size_t d = prev[m];
+    free(prev);
+    free(cur);
+    return d;
+}
+
+static void emit(worker_t *w, size_t index, uint64_t bytes, uint64_t chars, long expected_len, size_t errors, bool failed) {
+    batch_t *b = w->batch;
+
+    pthread_mutex_lock(&b->report_lock);
+    result_t *r = &b->results[index];
+    r->line = malloc(w->line.len + 1);
+    memcpy(r->line, w->line.data, w->line.len + 1);
+    r->len = w->line.len;
+    r->done = true;
+
+    b->bytes += bytes;
+    b->chars += chars;
+    if (expected_len >= 0) {
+        b->expected_chars += (uint64_t)expected_len;
+        b->expected_errors += errors;
+    }
+    if (failed) b->failed++;
+
+    // Stream out everything that is now contiguous
+    while (b->next_emit < b->count && b->results[b->next_emit].done) {
+        result_t *e = &b->results[b->next_emit];
+        fwrite(e->line, 1, e->len, b->report);
+        free(e->line);
+        e->line = NULL;
+        b->next_emit++;
+    }
+    pthread_mutex_unlock(&b->report_lock);
+}
+
+static void process(worker_t *w, size_t index) {
+    batch_t *b = w->batch;
+    const char *path = b->paths[index];
+    const char *kind = "trace";
+    const char *status = "ok";
+    bool failed = false;
+
+    w->text.len = 0;
+    if (w->text.data) w->text.data[0] = '\0';
+    morse_decoder_init(&w->decoder, &b->timing, on_sequence, &w->text);
+
+    mapped_file_t f = {0};
+    if (mapped_file_open(&f, path) != 0) {
+        status = "open failed";
+        failed = true;
+    } else if (wav_is_riff(f.data, f.size)) {
+        wav_t wav;
+        kind = "audio";
+        if (wav_parse(&wav, f.data, f.size) != 0) {
+            status = "unsupported wav";
+            failed = true;
+        } else {
+            audio_decode(&w->decoder, &wav);
+        }
+    } else {
+        if (trace_decode(&w->decoder, f.data, f.size) > 0) status = "bad lines";
+    }
+
+    // Optional reference text
+    long expected_len = -1;
+    size_t errors = 0;
+    uint32_t accuracy = 0;
+    if (!failed) {
+        strbuf_t name = {0};
+        sb_printf(&name, "%s.expected", path);
+        mapped_file_t e;
+        if (access(name.data, R_OK) == 0 && mapped_file_open(&e, name.data) == 0) {
+            strbuf_t expected = {0};
+            normalise(&expected, e.data, e.size);
+            mapped_file_close(&e);
+
+            expected_len = (long)expected.len;
+            errors = edit_distance(w->text.data ? w->text.data : "", w->text.len, expected.data, expected.len);
+            size_t right = errors < expected.len ? expected.len - errors : 0;
+            accuracy = expected.len ? (uint32_t)((right * 1000 + expected.len / 2) / expected.len) : 0;
+            free(expected.data);
+        }
+        free(name.data);
+    }
+
+    w->line.len = 0;
+    sb_printf(&w->line, "%zu\t%s\t%s\t%s\t%u\t%u\t%u\t%u\t", index, path, kind, status,
+              w->decoder.dots, w->decoder.dashes, w->decoder.chars, w->decoder.unknown);
+    if (expected_len >= 0) sb_printf(&w->line, "%u.%u", accuracy / 10, accuracy % 10);
+    else sb_append(&w->line, "-", 1);
+    sb_printf(&w->line, "\t%s\n", w->text.data ? w->text.data : "");
+
+    emit(w, index, f.size, w->decoder.chars, expected_len, errors, failed);
+    mapped_file_close(&f);
+}
+
+static uint32_t xorshift(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    batch_t *b = w->batch;
+    size_t item;
+
+    for (;;) {
+        if (queue_take(&b->queues[w->id], &item)) {
+            process(w, item);
+            continue;
+        }
+
+        // Own queue is empty, steal from a random victim, then sweep the rest
+        bool stolen = false;
+        int start = (int)(xorshift(&w->rng) % (uint32_t)b->threads);
+        for (int k = 0; k < b->threads && !stolen; k++) {
+            int victim = (start + k) % b->threads;
+            if (victim != w->id) stolen = queue_steal(&b->queues[victim], &item);
+        }
+        if (!stolen) break;     // Nothing new is ever queued, so everyone is done
+        process(w, item);
+    }
+    return NULL;
+}
+
+/* ---Command line--- */
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] [files...]\n"
+            "  -j N             worker threads (default: number of cores)\n"
+            "  -l FILE          read input paths from FILE, one per line (- for stdin)\n"
+            "  -o FILE          write the report to FILE (default: stdout)\n"
+            "  --dot-us N       longest hold that is still a dot  (default %u)\n"
+            "  --char-gap-us N  silence that ends a character    (default %u)\n"
+            "  --word-gap-us N  silence that ends a sequence     (default %u)\n",
+            argv0, MORSE_DOT_TIME, MORSE_CHAR_GAP, MORSE_WORD_GAP);
+}
+
+static void add_path(batch_t *b, size_t *cap, const char *path) {
+    if (b->count == *cap) {
+        *cap = *cap ? *cap * 2 : 1024;
+        b->paths = realloc(b->paths, *cap * sizeof(char *));
+    }
+    b->paths[b->count++] = strdup(path);
+}
+
+static void read_list(batch_t *b, size_t *cap, const char *list) {
+    FILE *in = strcmp(list, "-") == 0 ? stdin : fopen(list, "r");
+    if (!in) {
+        perror(list);
+        exit(1);
+    }
+
+    char *line = NULL;
+    size_t n = 0;
+    ssize_t len;
+    while ((len = getline(&line, &n, in)) > 0) {
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if (len > 0) add_path(b, cap, line);
+    }
+    free(line);
+    if (in != stdin) fclose(in);
+}
+
+static double now_s() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    batch_t b = {0};
+    size_t cap = 0;
+    const char *report_path = NULL;
+
+    b.timing.dot_time = MORSE_DOT_TIME;
+    b.timing.char_gap = MORSE_CHAR_GAP;
+    b.timing.word_gap = MORSE_WORD_GAP;
+    b.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(a, "-j") == 0 && has_value) b.threads = atoi(argv[++i]);
+        else if (strcmp(a, "-l") == 0 && has_value) read_list(&b, &cap, argv[++i]);
+        else if (strcmp(a, "-o") == 0 && has_value) report_path = argv[++i];
+        else if (strcmp(a, "--dot-us") == 0 && has_value) b.timing.dot_time = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(a, "--char-gap-us") == 0 && has_value) b.timing.char_gap = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(a, "--word-gap-us") == 0 && has_value) b.timing.word_gap = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (a[0] == '-' && a[1] != '\0') {
+            usage(argv[0]);
+            return 2;
+        } else add_path(&b, &cap, a);
+    }
+
+    if (b.count == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (b.threads < 1) b.threads = 1;
+    if ((size_t)b.threads > b.count) b.threads = (int)b.count;
+
+    b.report = report_path ? fopen(report_path, "w") : stdout;
+    if (!b.report) {
+        perror(report_path);
+        return 1;
+    }
+    fprintf(b.report, "index\tfile\ttype\tstatus\tdots\tdashes\tchars\tunknown\taccuracy\ttext\n");
+
+    // Deal the files out round-robin so every worker starts near the front of the list
+    b.results = calloc(b.count, sizeof(result_t));
+    b.queues = calloc((size_t)b.threads, sizeof(work_queue_t));
+    for (int t = 0; t < b.threads; t++) {
+        work_queue_t *q = &b.queues[t];
+        pthread_mutex_init(&q->lock, NULL);
+        q->items = malloc((b.count / (size_t)b.threads + 1) * sizeof(size_t));
+        for (size_t i = (size_t)t; i < b.count; i += (size_t)b.threads) q->items[q->tail++] = i;
+    }
+    pthread_mutex_init(&b.report_lock, NULL);
+
+    double start = now_s();
+
+    worker_t *workers = calloc((size_t)b.threads, sizeof(worker_t));
+    pthread_t *tids = calloc((size_t)b.threads, sizeof(pthread_t));
+    for (int t = 0; t < b.threads; t++) {
+        workers[t].batch = &b;
+        workers[t].id = t;
+        workers[t].rng = 0x9E3779B9u * (uint32_t)(t + 1);
+        pthread_create(&tids[t], NULL, worker_main, &workers[t]);
+    }
+    for (int t = 0; t < b.threads; t++) pthread_join(tids[t], NULL);
+
+    double elapsed = now_s() - start;
+    fflush(b.report);
+
+    fprintf(stderr, "%zu files (%zu failed), %.1f MB, %llu chars in %.3fs with %d threads: %.0f files/s, %.1f MB/s\n",
+            b.count, b.failed, (double)b.bytes / 1e6, (unsigned long long)b.chars, elapsed, b.threads,
+            (double)b.count / elapsed, (double)b.bytes / 1e6 / elapsed);
+    if (b.expected_chars > 0) {
+        uint64_t right = b.expected_errors < b.expected_chars ? b.expected_chars - b.expected_errors : 0;
+        uint64_t acc = (right * 1000 + b.expected_chars / 2) / b.expected_chars;
+        fprintf(stderr, "Overall accuracy %llu.%llu%% over %llu expected chars\n",
+                (unsigned long long)(acc / 10), (unsigned long long)(acc % 10), (unsigned long long)b.expected_chars);
+    }
+
+    for (int t = 0; t < b.threads; t++) {
+        free(workers[t].text.data);
+        free(workers[t].line.data);
+        free(b.queues[t].items);
+        pthread_mutex_destroy(&b.queues[t].lock);
+    }
+    for (size_t i = 0; i < b.count; i++) free(b.paths[i]);
+    free(b.paths);
+    free(b.results);
+    free(b.queues);
+    free(workers);
+    free(tids);
+    if (b.report != stdout) fclose(b.report);
+    return b.failed ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "channelizer.h"
+
+static void *alloc16(size_t bytes) {
+    void *p = NULL;
+    if (posix_memalign(&p, 16, bytes ? bytes : 16) != 0) return NULL;
+    return p;
+}
+
+// Unaligned safe, compiles to a single vector load / store
+static inline v4f load4(const float *p) {
+    v4f v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store4(float *p, v4f v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Returns 0 on success, -1 if size isn't a power of two >= 16 or memory runs out
+int channelizer_init(channelizer_t *c, int size) {
+    memset(c, 0, sizeof(*c));
+    if (size < 16 || (size & (size - 1))) return -1;
+
+    c->size = size;
+    while ((1 << c->log2n) < size) c->log2n++;
+
+    c->window = alloc16(size * sizeof(float));
+    c->twiddle_re = alloc16(size * sizeof(float));
+    c->twiddle_im = alloc16(size * sizeof(float));
+    c->twiddle_offset = malloc((c->log2n + 1) * sizeof(int));
+    c->bitrev = malloc(size * sizeof(uint32_t));
+    c->re = alloc16(size * sizeof(float));
+    c->im = alloc16(size * sizeof(float));
+    if (!c->window || !c->twiddle_re || !c->twiddle_im || !c->twiddle_offset || !c->bitrev || !c->re || !c->im) {
+        channelizer_free(c);
+        return -1;
+    }
+
+    for (int i = 0; i < size; i++) {
+        c->window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / size);
+
+        uint32_t r = 0;
+        for (int b = 0; b < c->log2n; b++) r |= ((i >> b) & 1u) << (c->log2n - 1 - b);
+        c->bitrev[i] = r;
+    }
+
+    // Stage s combines blocks of m = 2^s using m/2 twiddles; all stages fit in size entries
+    int off = 0;
+    for (int s = 1; s <= c->log2n; s++) {
+        int half = 1 << (s - 1);
+        c->twiddle_offset[s] = off;
+        for (int j = 0; j < half; j++) {
+            double a = -2.0 * M_PI * j / (2 * half);
+            c->twiddle_re[off + j] = (float)cos(a);
+            c->twiddle_im[off + j] = (float)sin(a);
+        }
+        off += half;
+    }
+    return 0;
+}
+
+void channelizer_free(channelizer_t *c) {
+    free(c->window);
+    free(c->twiddle_re);
+    free(c->twiddle_im);
+    free(c->twiddle_offset);
+    free(c->bitrev);
+    free(c->re);
+    free(c->im);
+    memset(c, 0, sizeof(*c));
+}
+
+/*
+    Window size samples, FFT them and write |X[k]|^2 for k = 0 .. size / 2.
+    Radix-2 decimation in time: the first two stages are scalar, every
+    stage after that has at least 4 butterflies per group and runs 4 wide.
+*/
+void channelizer_power(channelizer_t *c, const float *samples, float *power) {
+    const int n = c->size;
+    float *re = c->re;
+    float *im = c->im;
+
+    for (int i = 0; i < n; i++) {
+        uint32_t r = c->bitrev[i];
+        re[r] = samples[i] * c->window[i];
+        im[r] = 0.0f;
+    }
+
+    // Stage 1 and 2 (m = 2, 4)
+    for (int g = 0; g < n; g += 4) {
+        float ar = re[g] + re[g + 1], br = re[g] - re[g + 1];
+        float cr = re[g + 2] + re[g + 3], dr = re[g + 2] - re[g + 3];
+        float ai = im[g] + im[g + 1], bi = im[g] - im[g + 1];
+        float ci = im[g + 2] + im[g + 3], di = im[g + 2] - im[g + 3];
+
+        re[g] = ar + cr;
+        im[g] = ai + ci;
+        re[g + 2] = ar - cr;
+        im[g + 2] = ai - ci;
+
+        // Twiddle -j for the second butterfly
+        re[g + 1] = br + di;
+        im[g + 1] = bi - dr;
+        re[g + 3] = br - di;
+        im[g + 3] = bi + dr;
+    }
+
+    // Remaining stages, 4 butterflies at a time
+    for (int s = 3; s <= c->log2n; s++) {
+        const int half = 1 << (s - 1);
+        const float *wr = c->twiddle_re + c->twiddle_offset[s];
+        const float *wi = c->twiddle_im + c->twiddle_offset[s];
+
+        for (int g = 0; g < n; g += 2 * half) {
+            for (int j = 0; j < half; j += 4) {
+                float *ur = re + g + j, *ui = im + g + j;
+                float *vr = ur + half, *vi = ui + half;
+
+                v4f w_r = load4(wr + j), w_i = load4(wi + j);
+                v4f x_r = load4(vr), x_i = load4(vi);
+                v4f t_r = w_r * x_r - w_i * x_i;
+                v4f t_i = w_r * x_i + w_i * x_r;
+                v4f a_r = load4(ur), a_i = load4(ui);
+
+                store4(ur, a_r + t_r);
+                store4(ui, a_i + t_i);
+                store4(vr, a_r - t_r);
+                store4(vi, a_i - t_i);
+            }
+        }
+    }
+
+    // Power spectrum, the last (Nyquist) bin is done on its own
+    const int bins = n / 2;
+    for (int k = 0; k < bins; k += 4) {
+        v4f r = load4(re + k), i = load4(im + k);
+        store4(power + k, r * r + i * i);
+    }
+    power[bins] = re[bins] * re[bins] + im[bins] * im[bins];
+}
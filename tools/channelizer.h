@@ -0,0 +1,33 @@
+#ifndef CHANNELIZER_H
+#define CHANNELIZER_H
+
+#include <stdint.h>
+
+/*
+    Channelizer
+
+    Splits a block of real audio into FFT_SIZE / 2 + 1 frequency bins
+    with a Hann windowed FFT. The butterflies and the power stage use
+    GCC vector extensions, so they compile to SSE / NEON on the host
+    without any intrinsics.
+*/
+
+typedef float v4f __attribute__((vector_size(16)));
+
+typedef struct {
+    int size;                   // FFT length, power of two, at least 16
+    int log2n;
+    float *window;              // Hann window, size entries
+    float *twiddle_re;          // Per stage, contiguous so stages can be vectorised
+    float *twiddle_im;
+    int *twiddle_offset;        // Start of each stage's twiddles
+    uint32_t *bitrev;
+    float *re;                  // Work buffers
+    float *im;
+} channelizer_t;
+
+int  channelizer_init(channelizer_t *c, int size);
+void channelizer_free(channelizer_t *c);
+void channelizer_power(channelizer_t *c, const float *samples, float *power);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef FAKE_HARDWARE_SYNC_H
+#define FAKE_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Single threaded on the host, so there is nothing to disable
+static inline uint32_t save_and_disable_interrupts() {
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status) {
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef FAKE_HARDWARE_TIMER_H
+#define FAKE_HARDWARE_TIMER_H
+
+#include <stdint.h>
+
+// Just the TIMER registers scheduler.c touches, backed by plain memory
+typedef struct {
+    volatile uint32_t alarm[4];
+    volatile uint32_t armed;            // Real hardware: write 1 to disarm. Here the last write is kept.
+    volatile uint32_t inte;
+    volatile uint32_t intf;
+} timer_hw_t;
+
+extern timer_hw_t *timer_hw;
+
+// Simulated microsecond clock, the test moves it
+extern uint32_t fake_time_us;
+
+static inline uint32_t time_us_32() {
+    return fake_time_us;
+}
+
+static inline void hw_set_bits(volatile uint32_t *addr, uint32_t mask) {
+    *addr |= mask;
+}
+
+static inline void hw_clear_bits(volatile uint32_t *addr, uint32_t mask) {
+    *addr &= ~mask;
+}
+
+#endif
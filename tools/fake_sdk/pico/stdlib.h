@@ -0,0 +1,9 @@
+#ifndef FAKE_PICO_STDLIB_H
+#define FAKE_PICO_STDLIB_H
+
+// Host stand-in for the parts of the Pico SDK that scheduler.c uses, see scheduler_test.c
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/timer.h"
+
+#endif
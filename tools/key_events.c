@@ -0,0 +1,101 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include "key_events.h"
+
+static bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parse a trace straight out of the mapped file (no NULL terminator), returns the number of bad lines
+int trace_parse(const uint8_t *data, size_t size, key_edge_cb fn, void *user, uint32_t *last_us) {
+    const uint8_t *p = data;
+    const uint8_t *end = data + size;
+    uint32_t t = 0;
+    int bad = 0;
+
+    while (p < end) {
+        const uint8_t *eol = p;
+        while (eol < end && *eol != '\n') eol++;
+
+        while (p < eol && is_space(*p)) p++;
+        if (p < eol && *p != '#') {
+            // Time stamp
+            uint64_t v = 0;
+            const uint8_t *digits = p;
+            while (p < eol && '0' <= *p && *p <= '9') v = v * 10 + (*p++ - '0');
+            while (p < eol && is_space(*p)) p++;
+
+            // Key state, only the first character matters: 1/d(own) or 0/u(p)
+            if (p == digits || p == eol) {
+                bad++;
+            } else if (*p == '1' || *p == 'd') {
+                t = (uint32_t)v;
+                fn(user, true, t);
+            } else if (*p == '0' || *p == 'u') {
+                t = (uint32_t)v;
+                fn(user, false, t);
+            } else {
+                bad++;
+            }
+        }
+
+        p = eol + 1;
+    }
+
+    if (last_us) *last_us = t;
+    return bad;
+}
+
+static void key_edge(void *user, bool down, uint32_t t_us) {
+    morse_decoder_key(user, down, t_us);
+}
+
+int trace_decode(morse_decoder_t *d, const uint8_t *data, size_t size) {
+    uint32_t t = 0;
+    int bad = trace_parse(data, size, key_edge, d, &t);
+    morse_decoder_flush(d, t);
+    return bad;
+}
+
+/*
+    Single tone keying from audio: rectify, smooth with a one-pole
+    low pass (about 5ms) and key on/off with hysteresis at half and a
+    quarter of the loudest envelope. Integer maths throughout.
+*/
+int audio_decode(morse_decoder_t *d, const wav_t *w) {
+    if (w->frames == 0 || w->sample_rate == 0) return -1;
+
+    int shift = 0;
+    while ((1u << (shift + 1)) <= w->sample_rate / 200) shift++;
+
+    // Pass 1: loudest envelope
+    int64_t env = 0, peak = 0;
+    for (size_t i = 0; i < w->frames; i++) {
+        int32_t x = w->samples[i * w->channels];
+        env += (((int64_t)abs(x) << 16) - env) >> shift;
+        if (env > peak) peak = env;
+    }
+    if (peak < ((int64_t)64 << 16)) {
+        morse_decoder_flush(d, 0);
+        return 0;           // Silence
+    }
+
+    // Pass 2: edges
+    int64_t on = peak / 2, off = peak / 4;
+    bool key = false;
+    uint32_t t = 0;
+    env = 0;
+    for (size_t i = 0; i < w->frames; i++) {
+        int32_t x = w->samples[i * w->channels];
+        env += (((int64_t)abs(x) << 16) - env) >> shift;
+
+        if (key ? env < off : env > on) {
+            key = !key;
+            t = (uint32_t)((uint64_t)i * 1000000u / w->sample_rate);
+            morse_decoder_key(d, key, t);
+        }
+    }
+
+    morse_decoder_flush(d, (uint32_t)((uint64_t)w->frames * 1000000u / w->sample_rate));
+    return 0;
+}
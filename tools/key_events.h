@@ -0,0 +1,25 @@
+#ifndef KEY_EVENTS_H
+#define KEY_EVENTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "morse_decoder.h"
+#include "wav.h"
+
+/*
+    Turn recorded inputs into the key edges the GPIO ISR would have
+    seen, and feed them to a decoder.
+
+    Trace files are text, one edge per line:
+        <time in us> <1|0|down|up>
+    Blank lines and lines starting with '#' are ignored.
+*/
+
+typedef void (*key_edge_cb)(void *user, bool down, uint32_t t_us);
+
+int trace_parse(const uint8_t *data, size_t size, key_edge_cb fn, void *user, uint32_t *last_us);
+int trace_decode(morse_decoder_t *d, const uint8_t *data, size_t size);
+int audio_decode(morse_decoder_t *d, const wav_t *w);
+
+#endif
@@ -0,0 +1,42 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+// Map the whole file, returns 0 on success and -1 if it can't be opened or mapped
+int mapped_file_open(mapped_file_t *f, const char *path) {
+    f->data = NULL;
+    f->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // An empty file is valid, there is just nothing to map
+    if (st.st_size > 0) {
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        f->data = p;
+        f->size = (size_t)st.st_size;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    return 0;
+}
+
+void mapped_file_close(mapped_file_t *f) {
+    if (f->data) munmap((void *)f->data, f->size);
+    f->data = NULL;
+    f->size = 0;
+}
@@ -0,0 +1,20 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    Read-only memory mapped input file. Large corpora are decoded
+    straight out of the page cache without copying them into buffers.
+*/
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+} mapped_file_t;
+
+int  mapped_file_open(mapped_file_t *f, const char *path);
+void mapped_file_close(mapped_file_t *f);
+
+#endif
@@ -0,0 +1,462 @@
+/*
+    Multi-signal Decoder
+
+    Decodes every CW signal in a band of audio at once. The audio is
+    split into narrow channels with a windowed FFT (channelizer.c),
+    carriers are detected automatically from the spectrum, and each one
+    gets its own envelope keyer and morse_decoder_t, the same
+    dot/dash/char/sequence logic as the game. Finished words are
+    printed with a time stamp and their channel as they are decoded.
+
+    Real band signals are much faster than the game, so by default
+    each channel learns its own dot length from what it hears and sets
+    its thresholds from that (dot <= 2 units, char gap 2 units, word gap
+    5 units). --game-timing uses the game's fixed thresholds instead.
+    A channel that hasn't keyed for IDLE_S is freed for a new carrier.
+
+    Input is a 16-bit PCM .wav file, or raw signed 16-bit mono samples
+    on stdin with -r RATE. CPU time is measured for the channelizer and
+    for every channel and reported against the audio duration.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "channelizer.h"
+#include "mapped_file.h"
+#include "morse_decoder.h"
+#include "wav.h"
+
+#define MAX_CHANNELS    64
+#define BLOCK_FRAMES    32              // Spectra buffered before the channels run over them
+#define IDLE_S          10              // A channel silent this long is freed
+#define NARROW          10.0f           // A carrier is this far over the bins 2 either side, a click isn't
+
+typedef struct {
+    bool active;
+    int id;
+    int bin;
+    float hz;
+
+    // Envelope keyer
+    float prev;                         // Last frame's power, keying runs on a two frame average
+    float hi;                           // Signal level, peak hold with slow decay
+    float lo;                           // Noise level, averaged while the key is up
+    float noise;                        // Lower quartile of the level with the key up, for the squelch
+    bool key;
+    int pending;                        // Frames the keyer has disagreed with the key for
+    uint32_t pending_time;
+    uint32_t edge_time;
+
+    // Adaptive timing
+    bool adaptive;
+    uint32_t unit_us;
+
+    morse_decoder_t decoder;
+    uint64_t clock_us;                  // 64-bit time of the frame being fed to the decoder
+    uint64_t heard_us;                  // Last key edge, or when the carrier was found
+    double cpu_s;
+    uint32_t words;
+} channel_t;
+
+typedef struct {
+    // Input
+    const int16_t *samples;             // Mapped .wav, or NULL to read stdin
+    size_t frames;
+    size_t channels;
+    size_t pos;
+    uint32_t rate;
+
+    // Channelizer
+    int fft_size;
+    int hop;
+    int bins;
+    channelizer_t chz;
+    float *window_buf;
+    float *spectra;                     // BLOCK_FRAMES x bins
+    uint64_t *frame_time;               // Time stamp of each buffered spectrum, the decoder gets the low 32 bits
+
+    // Carrier detection, per bin
+    float *smooth;                      // Power with a short average
+    float *peak;                        // Maximum hold of smooth
+    float *low;                         // Minimum hold of smooth
+    uint16_t *run;                      // Frames in a row smooth has been snr over low, and the bin narrow
+    uint16_t *longest;                  // Longest run since the last detection pass
+    float *scratch;
+    int min_bin, max_bin;
+    float snr;
+    int detect_every;
+    int persist;                        // Run a carrier needs, a lone spike doesn't make one
+
+    channel_t chan[MAX_CHANNELS];
+    int nchan;                          // Slots in use or freed, chan[nchan] onwards never used
+    int next_id;
+    bool adaptive;
+} multi_t;
+
+static double cpu_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/*
+    The decoder keeps wrap-safe 32-bit microseconds, which wrap every
+    71.6 minutes. Its events are never more than a word gap from the
+    frame being fed in (flush stamps the last word a gap ahead), so the
+    printed time is rebuilt from that frame's 64-bit clock.
+*/
+static void on_sequence(morse_decoder_t *d, const char *text, uint32_t t_us) {
+    channel_t *c = d->user;
+    if (text[0] == '\0') return;
+    c->words++;
+
+    uint64_t t = c->clock_us + (int64_t)(int32_t)(t_us - (uint32_t)c->clock_us);
+    printf("%10.3f  ch%02d %6.0f Hz  %s\n", t / 1e6, c->id, c->hz, text);
+}
+
+// Fetch the next hop of samples as floats, returns how many were read
+static int next_hop(multi_t *m, float *dst) {
+    int n = 0;
+    if (m->samples) {
+        while (n < m->hop && m->pos < m->frames) dst[n++] = m->samples[m->pos++ * m->channels];
+    } else {
+        int16_t buf[4096];
+        int want = m->hop < 4096 ? m->hop : 4096;
+        n = (int)fread(buf, sizeof(int16_t), (size_t)want, stdin);
+        for (int i = 0; i < n; i++) dst[i] = buf[i];
+    }
+    return n;
+}
+
+static int cmp_float(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    Look for new carriers. A keyed carrier shows up as a bin whose
+    recent peak is well above its own recent minimum (it was on, then
+    off) and above the noise floor of the band, taken as the median of
+    the per bin minimums since a busy band can be mostly carriers.
+    The clicks of unshaped keying splash across the band at each edge,
+    so the bin must also have stood clear of the bins either side for
+    half a window at least once since the last pass.
+*/
+static void detect(multi_t *m) {
+    int n = m->max_bin - m->min_bin + 1;
+    memcpy(m->scratch, m->low + m->min_bin, n * sizeof(float));
+    qsort(m->scratch, (size_t)n, sizeof(float), cmp_float);
+    float floor = m->scratch[n / 2];
+    if (floor <= 0.0f) floor = 1e-9f;
+
+    for (int k = m->min_bin; k <= m->max_bin; k++) {
+        float p = m->peak[k];
+        if (p < floor * m->snr || p < m->low[k] * m->snr) continue;
+        if (p < m->peak[k - 1] || p < m->peak[k + 1]) continue;
+        if (m->longest[k] < m->persist) continue;
+
+        bool taken = false;
+        for (int c = 0; c < m->nchan && !taken; c++) taken = m->chan[c].active && abs(m->chan[c].bin - k) <= 1;
+        if (taken) continue;
+
+        int slot = 0;
+        while (slot < m->nchan && m->chan[slot].active) slot++;
+        if (slot == MAX_CHANNELS) break;
+        if (slot == m->nchan) m->nchan++;
+
+        channel_t *c = &m->chan[slot];
+        memset(c, 0, sizeof(*c));
+        c->active = true;
+        c->id = m->next_id++;
+        c->bin = k;
+        c->hz = (float)k * m->rate / m->fft_size;
+        c->adaptive = m->adaptive;
+        c->unit_us = 60000;                 // 20 WPM until it has heard something
+        c->hi = p;
+        c->lo = m->smooth[k] < p ? m->smooth[k] : p;
+        c->noise = m->low[k];
+        c->heard_us = m->frame_time[0];
+        morse_decoder_init(&c->decoder, NULL, on_sequence, c);
+        fprintf(stderr, "Carrier %d at %.0f Hz (%.1f dB over the floor)\n", c->id, c->hz, 10.0 * log10(p / floor));
+    }
+
+    memset(m->longest + m->min_bin, 0, n * sizeof(uint16_t));
+}
+
+// The carrier has gone, finish its last word and free the slot
+static void retire(multi_t *m, channel_t *c) {
+    morse_decoder_flush(&c->decoder, (uint32_t)c->clock_us);
+    c->active = false;
+    fprintf(stderr, "Carrier %d at %.0f Hz idle for %ds, freed (%u chars, %u words)\n", c->id, c->hz, IDLE_S,
+            c->decoder.chars, c->words);
+
+    // Forget its history, or the hold would find it again straight away
+    for (int k = c->bin - 1; k <= c->bin + 1; k++) m->peak[k] = m->smooth[k];
+}
+
+static void set_timing(channel_t *c) {
+    if (!c->adaptive) return;
+    c->decoder.timing.dot_time = 2 * c->unit_us;
+    c->decoder.timing.char_gap = 2 * c->unit_us;
+    c->decoder.timing.word_gap = 5 * c->unit_us;
+}
+
+/*
+    Key one channel through a block of spectra. The threshold sits
+    half way (in dB) between the signal and noise levels with a little
+    hysteresis, and the key only changes after the keyer has agreed
+    with itself for KEY_DEBOUNCE frames so noise spikes don't become
+    dots. The edge is stamped at the first of those frames. Once the
+    signal hold has decayed to within snr of the noise the carrier has
+    stopped, and the squelch keeps the key up.
+*/
+#define KEY_DEBOUNCE    2
+
+static void run_channel(multi_t *m, channel_t *c, int frames, float decay, float track, float rise) {
+    float fall = 1.0f / (rise * rise * rise);
+    for (int f = 0; f < frames; f++) {
+        float p = m->spectra[f * m->bins + c->bin];
+        float x = 0.5f * (p + c->prev);
+        uint32_t t = (uint32_t)m->frame_time[f];
+        c->clock_us = m->frame_time[f];
+        c->prev = p;
+
+        // Levels, noise is kept snr under the signal so a missed element can't drag it up
+        c->hi = x > c->hi ? x : c->hi * decay;
+        if (!c->key) c->lo += (x - c->lo) * track;
+        if (c->lo > c->hi / m->snr) c->lo = c->hi / m->snr;
+        float th = sqrtf(c->hi * c->lo);
+
+        /*
+            Once the carrier stops the clamp lets the threshold follow the
+            signal hold down into the noise, so the squelch compares the
+            hold against the real level between elements. A quartile
+            rather than an average, as at speed many of the key up frames
+            are still smeared by the window.
+        */
+        if (!c->key) c->noise *= x > c->noise ? rise : fall;
+        bool open = c->hi > c->noise * m->snr;
+        bool want = open && (c->key ? x > th * 0.7f : x > th * 1.4f);
+        if (want == c->key) {
+            c->pending = 0;
+            continue;
+        }
+        if (c->pending++ == 0) c->pending_time = t;
+        if (c->pending < KEY_DEBOUNCE) continue;
+
+        t = c->pending_time;
+        c->pending = 0;
+        c->key = want;
+        c->heard_us = m->frame_time[f];
+        morse_decoder_key(&c->decoder, want, t);
+
+        // Learn the dot length from each element: dots are 1 unit, dashes 3
+        if (!want && c->adaptive) {
+            uint32_t h = t - c->edge_time;
+            if (h * 3 >= c->unit_us) {
+                uint32_t unit = h < 2 * c->unit_us ? h : h / 3;
+                c->unit_us = (3 * c->unit_us + unit) / 4;
+                if (c->unit_us < 20000) c->unit_us = 20000;
+                if (c->unit_us > 300000) c->unit_us = 300000;
+                set_timing(c);
+            }
+        }
+        c->edge_time = t;
+    }
+    morse_decoder_advance(&c->decoder, (uint32_t)m->frame_time[frames - 1]);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [options] input.wav\n"
+            "       %s [options] -r RATE -        (raw s16le mono on stdin)\n"
+            "  -n N           FFT size (default gives ~20Hz bins, 2048 at 48kHz)\n"
+            "  --min-hz F     lowest carrier to look for  (default 200)\n"
+            "  --max-hz F     highest carrier to look for (default 3500)\n"
+            "  --snr DB       detection / keying threshold over the floor (default 20)\n"
+            "  --game-timing  use the game's fixed dot / gap thresholds\n",
+            argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+    multi_t m = {0};
+    const char *path = NULL;
+    float min_hz = 200.0f, max_hz = 3500.0f, snr_db = 20.0f;
+
+    m.adaptive = true;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(a, "-n") == 0 && has_value) m.fft_size = atoi(argv[++i]);
+        else if (strcmp(a, "-r") == 0 && has_value) m.rate = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(a, "--min-hz") == 0 && has_value) min_hz = (float)atof(argv[++i]);
+        else if (strcmp(a, "--max-hz") == 0 && has_value) max_hz = (float)atof(argv[++i]);
+        else if (strcmp(a, "--snr") == 0 && has_value) snr_db = (float)atof(argv[++i]);
+        else if (strcmp(a, "--game-timing") == 0) m.adaptive = false;
+        else if (a[0] == '-' && a[1] != '\0') {
+            usage(argv[0]);
+            return 2;
+        } else path = a;
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    mapped_file_t f = {0};
+    if (strcmp(path, "-") != 0) {
+        wav_t w;
+        if (mapped_file_open(&f, path) != 0 || wav_parse(&w, f.data, f.size) != 0) {
+            fprintf(stderr, "%s: not a 16-bit PCM wav file\n", path);
+            return 1;
+        }
+        m.samples = w.samples;
+        m.frames = w.frames;
+        m.channels = w.channels;
+        m.rate = w.sample_rate;
+    } else if (m.rate == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Default to ~20Hz bins (100Hz spaced signals stay clear of each other's leakage) and a hop of <= 6ms
+    if (m.fft_size == 0) for (m.fft_size = 16; m.fft_size < (int)m.rate / 24; m.fft_size *= 2);
+    if (channelizer_init(&m.chz, m.fft_size) != 0) {
+        fprintf(stderr, "FFT size must be a power of two >= 16\n");
+        return 2;
+    }
+    for (m.hop = m.fft_size / 4; m.hop > 16 && m.hop * 160 > (int)m.rate; m.hop /= 2);
+    m.bins = m.fft_size / 2 + 1;
+    m.snr = powf(10.0f, snr_db / 10.0f);
+    m.min_bin = (int)(min_hz * m.fft_size / m.rate);
+    m.max_bin = (int)(max_hz * m.fft_size / m.rate);
+    if (m.min_bin < 3) m.min_bin = 3;                // Room for the holds and the narrow check either side
+    if (m.max_bin > m.bins - 4) m.max_bin = m.bins - 4;
+    if (m.min_bin > m.max_bin) {
+        fprintf(stderr, "No FFT bins between %.0f and %.0f Hz\n", min_hz, max_hz);
+        return 2;
+    }
+    m.detect_every = (int)(m.rate / 4 / m.hop);     // Every 0.25s
+    if (m.detect_every < 1) m.detect_every = 1;
+    m.persist = m.fft_size / m.hop / 2;             // Half a window
+
+    m.window_buf = calloc((size_t)m.fft_size, sizeof(float));
+    m.spectra = malloc((size_t)BLOCK_FRAMES * m.bins * sizeof(float));
+    m.frame_time = malloc(BLOCK_FRAMES * sizeof(uint64_t));
+    m.smooth = calloc((size_t)m.bins, sizeof(float));
+    m.peak = calloc((size_t)m.bins, sizeof(float));
+    m.low = calloc((size_t)m.bins, sizeof(float));
+    m.run = calloc((size_t)m.bins, sizeof(uint16_t));
+    m.longest = calloc((size_t)m.bins, sizeof(uint16_t));
+    m.scratch = malloc((size_t)m.bins * sizeof(float));
+
+    // Per frame smoothing constants
+    float frame_s = (float)m.hop / m.rate;
+    float smooth_a = frame_s / 0.03f;               // 30ms average before the holds
+    float peak_decay = expf(-frame_s / 3.0f);       // 3s peak / minimum holds for detection
+    float low_rise = expf(frame_s / 3.0f);
+    float hi_decay = expf(-frame_s / 2.0f);         // 2s signal hold and 50ms noise average per channel
+    float track = frame_s / 0.05f;
+    float noise_rise = powf(10.0f, 0.3f * frame_s);  // Squelch noise quartile moves 3dB/s up, 9dB/s down
+
+    double cpu_start = cpu_now();
+    double chz_cpu = 0.0;
+    uint64_t frame = 0;
+    uint64_t samples_in = 0;
+    int filled = 0;
+
+    for (;;) {
+        double t0 = cpu_now();
+
+        // Channelize up to a block of frames
+        int frames = 0;
+        bool eof = false;
+        while (frames < BLOCK_FRAMES) {
+            memmove(m.window_buf, m.window_buf + m.hop, (size_t)(m.fft_size - m.hop) * sizeof(float));
+            int got = next_hop(&m, m.window_buf + m.fft_size - m.hop);
+            if (got < m.hop) {
+                eof = true;
+                break;
+            }
+            samples_in += (uint64_t)got;
+
+            float *p = m.spectra + (size_t)frames * m.bins;
+            channelizer_power(&m.chz, m.window_buf, p);
+            uint64_t centre = samples_in > (uint64_t)m.fft_size / 2 ? samples_in - m.fft_size / 2 : 0;
+            m.frame_time[frames] = centre * 1000000u / m.rate;
+
+            // Holds only start once the first window is full of audio
+            if (++filled >= m.fft_size / m.hop) {
+                for (int k = m.min_bin - 1; k <= m.max_bin + 1; k++) {
+                    float s = m.smooth[k] += (p[k] - m.smooth[k]) * smooth_a;
+                    m.peak[k] = s > m.peak[k] * peak_decay ? s : m.peak[k] * peak_decay;
+                    m.low[k] = (m.low[k] == 0.0f || s < m.low[k] * low_rise) ? s : m.low[k] * low_rise;
+                    bool narrow = p[k] > NARROW * (p[k - 2] + p[k + 2]);
+                    m.run[k] = s > m.low[k] * m.snr && narrow ? m.run[k] + (m.run[k] < UINT16_MAX) : 0;
+                    if (m.run[k] > m.longest[k]) m.longest[k] = m.run[k];
+                }
+                if (frame % (uint64_t)m.detect_every == 0) detect(&m);
+            }
+
+            frames++;
+            frame++;
+        }
+        chz_cpu += cpu_now() - t0;
+
+        // Every channel works through the block on its own
+        for (int c = 0; c < m.nchan && frames > 0; c++) {
+            channel_t *ch = &m.chan[c];
+            if (!ch->active) continue;
+
+            double c0 = cpu_now();
+            run_channel(&m, ch, frames, hi_decay, track, noise_rise);
+            ch->cpu_s += cpu_now() - c0;
+            if (ch->clock_us - ch->heard_us > (uint64_t)IDLE_S * 1000000u) retire(&m, ch);
+        }
+        fflush(stdout);
+
+        if (eof) break;
+    }
+
+    uint64_t end_us = samples_in * 1000000u / m.rate;
+    for (int c = 0; c < m.nchan; c++) {
+        if (!m.chan[c].active) continue;
+        m.chan[c].clock_us = end_us;
+        morse_decoder_flush(&m.chan[c].decoder, (uint32_t)end_us);
+    }
+    fflush(stdout);
+
+    // CPU report, as a percentage of one core over the length of the audio
+    double audio_s = (double)samples_in / m.rate;
+    double total_cpu = cpu_now() - cpu_start;
+    if (audio_s <= 0.0) audio_s = 1e-9;
+    fprintf(stderr, "\n%.1fs of audio at %u Hz in %.3fs CPU: %.1fx real time, %.2f%% of one core\n",
+            audio_s, m.rate, total_cpu, audio_s / total_cpu, 100.0 * total_cpu / audio_s);
+    fprintf(stderr, "Channelizer (%d point FFT, %.1f Hz bins): %.2f%%\n", m.fft_size, (double)m.rate / m.fft_size,
+            100.0 * chz_cpu / audio_s);
+    for (int c = 0; c < m.nchan; c++) {
+        channel_t *ch = &m.chan[c];
+        if (!ch->active) continue;
+        fprintf(stderr, "  ch%02d %6.0f Hz  %4.1f WPM  %5u chars %4u words  CPU %.4f%%\n", ch->id, ch->hz,
+                1200000.0 / ch->unit_us, ch->decoder.chars, ch->words, 100.0 * ch->cpu_s / audio_s);
+    }
+
+    channelizer_free(&m.chz);
+    free(m.window_buf);
+    free(m.spectra);
+    free(m.frame_time);
+    free(m.smooth);
+    free(m.peak);
+    free(m.low);
+    free(m.run);
+    free(m.longest);
+    free(m.scratch);
+    mapped_file_close(&f);
+    return 0;
+}
@@ -0,0 +1,320 @@
+/*
+    Round Replay
+
+    Replays recorded game sessions (key traces) and measures how long
+    each question took, comparing the old behaviour (wait for ALARM1
+    and compare the whole input) against the fail-fast check that
+    end_char() now runs on every committed character.
+
+    A fail-fast decision shows the next question straight away, and
+    the player answers it as soon as they've read it. The trace only
+    has the answers as they were keyed against the old firmware, so
+    each answer is moved to start the same reaction time after its
+    prompt as it did in the recording (the prompt used to appear when
+    the sequence gap ran out). A word that fails part way through is
+    drained like the firmware does: the rest of it is thrown away and
+    the next prompt waits for the sequence gap. Characters of a new
+    answer that get thrown away are reported as lost.
+
+    "<file>.expected" lists the target of each round, one per
+    sequence, separated by whitespace. A round is timed from its
+    first key-down, a question from its prompt to the next one.
+*/
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "key_events.h"
+#include "mapped_file.h"
+#include "morse_decoder.h"
+
+#define MAX_TARGET 32
+
+typedef struct {
+    uint32_t t_us;
+    bool down;
+} edge_t;
+
+typedef struct {
+    edge_t *edges;
+    size_t count;
+    size_t cap;
+} edge_list_t;
+
+// One recorded answer: its edges and how long after its prompt it started
+typedef struct {
+    size_t first;
+    size_t count;
+    uint32_t reaction_us;
+} answer_t;
+
+typedef struct {
+    // Targets for this session
+    char (*targets)[MAX_TARGET];
+    int count;
+
+    // Current round
+    bool fail_fast;
+    int round;
+    int answer;                         // Recorded answer being keyed
+    uint32_t round_start;
+    uint32_t prompt_at;                 // Next prompt, 0 until the round is over
+    bool prompted;
+    bool draining;
+    int drain_answer;                   // Answer whose rest is being drained
+    bool *passed;                       // Full compare of each recorded answer (ALARM1 run)
+
+    // Totals
+    uint64_t rounds;
+    uint64_t early;
+    uint64_t disagree;
+    uint64_t drained_rounds;
+    uint64_t drained_chars;
+    uint64_t lost_chars;
+    uint64_t decision_us;
+    uint64_t question_us;
+} replay_t;
+
+static void add_edge(void *user, bool down, uint32_t t_us) {
+    edge_list_t *l = user;
+    if (l->count > 0 ? l->edges[l->count - 1].down == down : !down) return;
+
+    if (l->count == l->cap) {
+        l->cap = l->cap ? l->cap * 2 : 256;
+        l->edges = realloc(l->edges, l->cap * sizeof(*l->edges));
+    }
+    l->edges[l->count++] = (edge_t){t_us, down};
+}
+
+// The round is over, the next prompt is shown at t_us
+static void end_round(replay_t *r, morse_decoder_t *d, uint32_t t_us) {
+    r->decision_us += t_us - r->round_start;
+    r->rounds++;
+    r->round++;
+    if (!r->draining) {
+        r->prompt_at = t_us;
+        r->prompted = true;
+    }
+}
+
+static void on_char(morse_decoder_t *d, char c, uint32_t t_us) {
+    replay_t *r = d->user;
+
+    // Draining, end_char() throws the character away
+    if (r->draining) {
+        d->input_index--;
+        if (r->answer == r->drain_answer) r->drained_chars++;
+        else r->lost_chars++;
+        return;
+    }
+    if (!r->fail_fast || r->round >= r->count) return;
+
+    const char *target = r->targets[r->round];
+    morse_match_t m = morse_match_prefix(d->input, d->input_index, target);
+    if (m == MATCH_PENDING) return;
+
+    r->early++;
+    if ((m == MATCH_PASS) != r->passed[r->round]) r->disagree++;
+
+    // A word that failed with letters left is still being keyed, the word gap stays armed as the drain
+    if (m == MATCH_FAIL && d->input_index < (int)strlen(target)) {
+        r->draining = true;
+        r->drain_answer = r->answer;
+        r->drained_rounds++;
+    } else {
+        d->seq_armed = false;
+    }
+
+    d->input_index = 0;
+    d->morse_index = 0;
+    end_round(r, d, t_us);
+}
+
+static void on_sequence(morse_decoder_t *d, const char *text, uint32_t t_us) {
+    replay_t *r = d->user;
+
+    // The drain is over, now the held back prompt is shown
+    if (r->draining) {
+        r->draining = false;
+        r->prompt_at = t_us;
+        r->prompted = true;
+        return;
+    }
+    if (r->round >= r->count) return;
+
+    // ALARM1 path: the whole input against the target, as state_processor() does
+    if (!r->fail_fast) r->passed[r->round] = strcmp(text, r->targets[r->round]) == 0;
+    end_round(r, d, t_us);
+}
+
+// Cut the trace into answers: a new one starts with the first press after a sequence gap
+static int split_answers(const edge_list_t *l, answer_t *a) {
+    int n = 0;
+    uint32_t up = 0;
+    for (size_t i = 0; i < l->count; i++) {
+        if (!l->edges[i].down) {
+            up = l->edges[i].t_us;
+            continue;
+        }
+
+        uint32_t t = l->edges[i].t_us;
+        if (n == 0 || t - up >= MORSE_WORD_GAP) {
+            a[n].first = i;
+            a[n].count = 0;
+            a[n].reaction_us = n == 0 ? t : t - (up + MORSE_WORD_GAP);
+            n++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        size_t next = i + 1 < n ? a[i + 1].first : l->count;
+        a[i].count = next - a[i].first;
+    }
+    return n;
+}
+
+// Key every answer a reaction time after its prompt, with or without the fail-fast check
+static void replay(replay_t *r, const edge_list_t *l, const answer_t *a, int answers, bool fail_fast) {
+    morse_decoder_t d;
+    morse_decoder_init(&d, NULL, on_sequence, r);
+    d.on_char = on_char;
+
+    r->fail_fast = fail_fast;
+    r->round = 0;
+    r->draining = false;
+
+    uint32_t prompt = 0, last = 0;
+    for (int i = 0; i < answers && r->round < r->count; i++) {
+        // Never before the previous answer's last edge, in case keying ran past the decision
+        uint32_t start = prompt + a[i].reaction_us;
+        if (i > 0 && (int32_t)(start - last) <= 0) start = last + 1;
+
+        const edge_t *e = &l->edges[a[i].first];
+        r->answer = i;
+        r->round_start = start;
+        r->prompted = false;
+        for (size_t k = 0; k < a[i].count; k++) {
+            last = start + (e[k].t_us - e[0].t_us);
+            morse_decoder_key(&d, e[k].down, last);
+        }
+        if (d.key_down) morse_decoder_key(&d, false, ++last);
+
+        // Let the gaps run out, the next prompt is known by then
+        if (!r->prompted) morse_decoder_advance(&d, d.up_time + d.timing.word_gap);
+        if (!r->prompted) break;
+
+        r->question_us += r->prompt_at - prompt;
+        prompt = r->prompt_at;
+    }
+}
+
+// Split the expected file into upper case targets
+static int load_targets(replay_t *r, const char *path) {
+    char name[4096];
+    snprintf(name, sizeof(name), "%s.expected", path);
+
+    mapped_file_t f;
+    if (mapped_file_open(&f, name) != 0) return -1;
+
+    r->count = 0;
+    r->targets = malloc((f.size / 2 + 1) * sizeof(*r->targets));
+    size_t i = 0;
+    while (i < f.size) {
+        while (i < f.size && isspace(f.data[i])) i++;
+        if (i >= f.size) break;
+
+        int n = 0;
+        while (i < f.size && !isspace(f.data[i])) {
+            if (n < MAX_TARGET - 1) r->targets[r->count][n++] = (char)toupper(f.data[i]);
+            i++;
+        }
+        r->targets[r->count][n] = '\0';
+        r->count++;
+    }
+
+    mapped_file_close(&f);
+    return 0;
+}
+
+static void print_times(const char *name, const replay_t *r) {
+    printf("Average decision (%s):%*s%llums, question %llums\n", name, (int)(9 - strlen(name)), "",
+           (unsigned long long)(r->decision_us / r->rounds / 1000),
+           (unsigned long long)(r->question_us / r->rounds / 1000));
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s session.trace...\n", argv[0]);
+        return 2;
+    }
+
+    replay_t base = {0}, fast = {0};
+    for (int i = 1; i < argc; i++) {
+        replay_t r = {0};
+        if (load_targets(&r, argv[i]) != 0) {
+            fprintf(stderr, "%s: no .expected file, skipped\n", argv[i]);
+            continue;
+        }
+
+        mapped_file_t f;
+        if (mapped_file_open(&f, argv[i]) != 0) {
+            fprintf(stderr, "%s: can't open, skipped\n", argv[i]);
+            free(r.targets);
+            continue;
+        }
+
+        edge_list_t l = {0};
+        trace_parse(f.data, f.size, add_edge, &l, NULL);
+        mapped_file_close(&f);
+
+        answer_t *a = malloc((l.count / 2 + 1) * sizeof(*a));
+        int answers = split_answers(&l, a);
+        r.passed = calloc(r.count + 1, sizeof(*r.passed));
+
+        // The ALARM1 run first, it gives the full compare each early decision is checked against
+        replay_t b = r, ff = r;
+        replay(&b, &l, a, answers, false);
+        ff.passed = b.passed;
+        replay(&ff, &l, a, answers, true);
+
+        base.rounds += b.rounds;
+        base.decision_us += b.decision_us;
+        base.question_us += b.question_us;
+        fast.rounds += ff.rounds;
+        fast.early += ff.early;
+        fast.disagree += ff.disagree;
+        fast.drained_rounds += ff.drained_rounds;
+        fast.drained_chars += ff.drained_chars;
+        fast.lost_chars += ff.lost_chars;
+        fast.decision_us += ff.decision_us;
+        fast.question_us += ff.question_us;
+
+        free(r.passed);
+        free(a);
+        free(l.edges);
+        free(r.targets);
+    }
+
+    if (base.rounds == 0 || fast.rounds == 0) {
+        fprintf(stderr, "No rounds replayed\n");
+        return 1;
+    }
+
+    printf("Rounds replayed:             %llu\n", (unsigned long long)base.rounds);
+    printf("Decided before ALARM1:       %llu\n", (unsigned long long)fast.early);
+    printf("Drained after a failed word: %llu rounds, %llu chars discarded\n",
+           (unsigned long long)fast.drained_rounds, (unsigned long long)fast.drained_chars);
+    printf("Next answer chars lost:      %llu\n", (unsigned long long)fast.lost_chars);
+    print_times("ALARM1", &base);
+    print_times("fast", &fast);
+    printf("Time saved per question:     %llums\n",
+           (unsigned long long)((base.question_us / base.rounds - fast.question_us / fast.rounds) / 1000));
+
+    bool bad = fast.disagree || fast.lost_chars || fast.rounds != base.rounds;
+    if (fast.disagree) printf("WARNING: %llu early decisions disagree with the full compare\n", (unsigned long long)fast.disagree);
+    if (fast.lost_chars) printf("WARNING: %llu characters of a new answer were thrown away\n", (unsigned long long)fast.lost_chars);
+    if (fast.rounds != base.rounds) printf("WARNING: %llu rounds replayed with fail-fast\n", (unsigned long long)fast.rounds);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,337 @@
+/*
+    Scheduler Test
+
+    Fixed cases for timer_wheel.c and scheduler.c against a simulated
+    clock. scheduler.c is built against fake_sdk/, which backs the
+    TIMER registers with memory, so reprogram()'s alarm, forced INTF
+    and disarm can be checked directly. Run by ctest.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "hardware/timer.h"
+#include "scheduler.h"
+#include "timer_wheel.h"
+
+#define LAP_US      ((uint32_t)WHEEL_SLOTS << WHEEL_SHIFT)
+
+static timer_hw_t fake_timer;
+timer_hw_t *timer_hw = &fake_timer;
+uint32_t fake_time_us;
+
+static int failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);        \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+// Every callback records which deadline fired and at what time
+typedef struct {
+    deadline_t d;
+    int fired;
+    uint32_t fired_at;
+    deadline_t *other;          // Cancelled or re-armed by the callback
+    uint32_t other_when;
+} probe_t;
+
+static timer_wheel_t wheel;
+static uint32_t now;
+static int order[8];
+static int order_len;
+
+static void record(probe_t *t) {
+    t->fired++;
+    t->fired_at = now;
+    if (order_len < 8) order[order_len++] = (int)t->d.when;
+}
+
+static void on_fire(void *arg) {
+    record(arg);
+}
+
+static void cancel_other(void *arg) {
+    probe_t *t = arg;
+    record(t);
+    wheel_cancel(&wheel, t->other);
+}
+
+static void rearm_other(void *arg) {
+    probe_t *t = arg;
+    record(t);
+    wheel_insert(&wheel, t->other, t->other_when, on_fire, t->other->arg);
+}
+
+static void reset(uint32_t start) {
+    now = start;
+    order_len = 0;
+    wheel_init(&wheel, start);
+}
+
+static void arm(probe_t *t, uint32_t when, deadline_cb fn) {
+    t->fired = 0;
+    wheel_insert(&wheel, &t->d, when, fn, t);
+}
+
+static void run_to(uint32_t t) {
+    now = t;
+    wheel_run(&wheel, now);
+}
+
+// A callback cancels another deadline that is due in the same run
+static void test_cancel_from_callback() {
+    probe_t a = {0}, b = {0};
+    reset(0);
+    arm(&a, 1000, cancel_other);
+    arm(&b, 2000, on_fire);
+    a.other = &b.d;
+
+    run_to(3000);
+    CHECK(a.fired == 1);
+    CHECK(b.fired == 0);
+    CHECK(!b.d.armed);
+    CHECK(wheel.pending == 0);
+}
+
+// A callback moves another due deadline into the future, it fires once at the new time
+static void test_rearm_from_callback() {
+    probe_t a = {0}, b = {0};
+    reset(0);
+    arm(&a, 1000, rearm_other);
+    arm(&b, 2000, on_fire);
+    a.other = &b.d;
+    a.other_when = 5000000;
+
+    run_to(3000);
+    CHECK(a.fired == 1);
+    CHECK(b.fired == 0);
+    CHECK(b.d.armed);
+    CHECK(wheel.pending == 1);
+
+    uint32_t next = 0;
+    CHECK(wheel_next(&wheel, now, &next) && next == 5000000);
+    run_to(4999999);
+    CHECK(b.fired == 0);
+    run_to(5000000);
+    CHECK(b.fired == 1 && b.fired_at == 5000000);
+    CHECK(wheel.pending == 0);
+}
+
+// A callback inserts a deadline that is already due, it fires in the same run after the first
+static void test_insert_due_from_callback() {
+    probe_t a = {0}, b = {0};
+    reset(0);
+    arm(&a, 2000, rearm_other);
+    a.other = &b.d;
+    a.other_when = 1500;
+    b.d.arg = &b;
+
+    run_to(3000);
+    CHECK(a.fired == 1);
+    CHECK(b.fired == 1);
+    CHECK(order_len == 2 && order[0] == 2000 && order[1] == 1500);
+    CHECK(wheel.pending == 0);
+}
+
+// Deadlines in the same run fire earliest first
+static void test_order() {
+    probe_t t[3] = {0};
+    reset(0);
+    arm(&t[0], 900, on_fire);
+    arm(&t[1], 300, on_fire);
+    arm(&t[2], 600, on_fire);
+
+    run_to(1000);
+    CHECK(order_len == 3 && order[0] == 300 && order[1] == 600 && order[2] == 900);
+}
+
+// A deadline that is already in the past when inserted is next, and fires on the next run
+static void test_past_deadline() {
+    probe_t a = {0};
+    reset(100000);
+    arm(&a, 40000, on_fire);
+
+    uint32_t next = 0;
+    CHECK(wheel_next(&wheel, now, &next) && next == 40000);
+    run_to(100001);
+    CHECK(a.fired == 1);
+    CHECK(wheel.pending == 0);
+}
+
+// More than one lap out: not fired as the wheel passes its slot on earlier laps
+static void test_beyond_one_lap() {
+    probe_t a = {0}, b = {0};
+    reset(0);
+    arm(&a, 2 * LAP_US + 1234, on_fire);
+    arm(&b, 1234, on_fire);
+
+    uint32_t next = 0;
+    CHECK(wheel_next(&wheel, now, &next) && next == 1234);
+    run_to(1234);
+    CHECK(b.fired == 1);
+    CHECK(wheel_next(&wheel, now, &next) && next == 2 * LAP_US + 1234);
+
+    run_to(LAP_US + 1234);
+    CHECK(a.fired == 0);
+    run_to(2 * LAP_US + 1233);
+    CHECK(a.fired == 0);
+    run_to(2 * LAP_US + 1234);
+    CHECK(a.fired == 1 && a.fired_at == 2 * LAP_US + 1234);
+}
+
+// Across the 32-bit wrap, a deadline just past zero is neither early nor lost
+static void test_wrap() {
+    probe_t a = {0}, b = {0};
+    reset(0xFFFFF000u);
+    arm(&a, 0x00001000u, on_fire);
+    arm(&b, 0xFFFFF800u, on_fire);
+
+    uint32_t next = 0;
+    CHECK(wheel_next(&wheel, now, &next) && next == 0xFFFFF800u);
+    run_to(0xFFFFFFFFu);
+    CHECK(b.fired == 1);
+    CHECK(a.fired == 0);
+    run_to(0x00000FFFu);
+    CHECK(a.fired == 0);
+    run_to(0x00001000u);
+    CHECK(a.fired == 1);
+    CHECK(wheel.pending == 0);
+}
+
+// Scheduler: what reprogram() leaves in the TIMER registers
+static deadline_t char_gap, word_gap;
+static int char_fired, word_fired;
+
+static void word_due(void *arg) {
+    word_fired++;
+}
+
+// Like end_char() starting a drain after a fail-fast decision, the word gap is left armed
+static void char_due(void *arg) {
+    char_fired++;
+}
+
+// Key edges as the GPIO ISR handles them, cancel_gaps() on a press and schedule_gaps() on a release
+static void press() {
+    scheduler_cancel(&char_gap);
+    scheduler_cancel(&word_gap);
+}
+
+static void release() {
+    scheduler_in(&char_gap, 1000, char_due, NULL);
+    scheduler_in(&word_gap, 2000, word_due, NULL);
+}
+
+static void test_scheduler() {
+    fake_timer = (timer_hw_t){0};
+    fake_time_us = 1000;
+    scheduler_init();
+    CHECK(!(timer_hw->inte & 1));
+
+    // Future deadline: ALARM0 points at it, nothing forced
+    scheduler_at(&word_gap, 9000, word_due, NULL);
+    CHECK(timer_hw->alarm[0] == 9000);
+    CHECK(timer_hw->inte & 1);
+    CHECK(!(timer_hw->intf & 1));
+
+    // An earlier one takes over the alarm
+    scheduler_at(&char_gap, 5000, char_due, NULL);
+    CHECK(timer_hw->alarm[0] == 5000);
+
+    // Cancelling the earliest moves the alarm back
+    scheduler_cancel(&char_gap);
+    CHECK(timer_hw->alarm[0] == 9000);
+
+    // Cancelling the last disarms ALARM0 and masks it
+    scheduler_cancel(&word_gap);
+    CHECK(!(timer_hw->inte & 1));
+    CHECK(timer_hw->armed == 1);
+
+    // A deadline already passed can't be matched by the alarm, so INTF is forced
+    fake_time_us = 20000;
+    scheduler_at(&word_gap, 19000, word_due, NULL);
+    CHECK(timer_hw->intf & 1);
+    scheduler_run();
+    CHECK(word_fired == 1);
+    CHECK(!(timer_hw->intf & 1));
+    CHECK(!(timer_hw->inte & 1));
+
+    // Draining: the char gap fires and the word gap stays armed on ALARM0
+    word_fired = 0;
+    release();
+    fake_time_us += 1500;
+    scheduler_run();
+    CHECK(char_fired == 1);
+    CHECK(word_fired == 0);
+    CHECK(word_gap.armed);
+    CHECK(timer_hw->alarm[0] == word_gap.when);
+
+    // The player keys on, a press cancels the word gap and the release pushes it back
+    fake_time_us += 200;
+    press();
+    CHECK(!word_gap.armed);
+    CHECK(!(timer_hw->inte & 1));
+    fake_time_us += 100;
+    release();
+    uint32_t word_when = word_gap.when;
+    CHECK(timer_hw->alarm[0] == char_gap.when);
+
+    // Past the first word gap's old time, nothing fires
+    fake_time_us += 700;
+    scheduler_run();
+    CHECK(char_fired == 1);
+    CHECK(word_fired == 0);
+
+    // The char gap again, then the word gap fires once at its new time
+    fake_time_us += 300;
+    scheduler_run();
+    CHECK(char_fired == 2);
+    CHECK(word_fired == 0);
+    CHECK(timer_hw->alarm[0] == word_when);
+    fake_time_us = word_when;
+    scheduler_run();
+    CHECK(word_fired == 1);
+    CHECK(!word_gap.armed);
+    CHECK(!(timer_hw->inte & 1));
+
+    // Deadlines left after a run are reprogrammed
+    word_fired = 0;
+    scheduler_in(&word_gap, 1000, word_due, NULL);
+    scheduler_in(&char_gap, 3000000, char_due, NULL);
+    fake_time_us += 1500;
+    scheduler_run();
+    CHECK(word_fired == 1);
+    CHECK(char_gap.armed);
+    CHECK(timer_hw->alarm[0] == char_gap.when);
+    CHECK(timer_hw->inte & 1);
+    CHECK(!(timer_hw->intf & 1));
+}
+
+typedef struct {
+    const char *name;
+    void (*fn)();
+} test_case_t;
+
+int main() {
+    static const test_case_t tests[] = {
+        {"cancel from callback", test_cancel_from_callback},
+        {"re-arm from callback", test_rearm_from_callback},
+        {"insert due from callback", test_insert_due_from_callback},
+        {"fire order", test_order},
+        {"deadline in the past", test_past_deadline},
+        {"more than a lap out", test_beyond_one_lap},
+        {"32-bit wrap", test_wrap},
+        {"scheduler reprogram", test_scheduler},
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        int before = failures;
+        tests[i].fn();
+        printf("%-26s %s\n", tests[i].name, failures == before ? "ok" : "FAILED");
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+#include <string.h>
+#include "wav.h"
+
+static uint32_t rd32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool wav_is_riff(const uint8_t *data, size_t size) {
+    return size >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WAVE", 4) == 0;
+}
+
+// Walk the chunks for "fmt " and "data", returns 0 on success and -1 for anything unsupported
+int wav_parse(wav_t *w, const uint8_t *data, size_t size) {
+    memset(w, 0, sizeof(*w));
+    if (!wav_is_riff(data, size)) return -1;
+
+    bool have_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = data + pos;
+        uint32_t len = rd32(chunk + 4);
+        size_t body = pos + 8;
+        if (len > size - body) len = (uint32_t)(size - body);   // Truncated recording, use what's there
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && len >= 16) {
+            uint16_t format = rd16(data + body);
+            w->channels = rd16(data + body + 2);
+            w->sample_rate = rd32(data + body + 4);
+            uint16_t bits = rd16(data + body + 14);
+            if (format != 1 || bits != 16 || w->channels == 0) return -1;
+            have_fmt = true;
+        } else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+            w->samples = (const int16_t *)(data + body);
+            w->frames = len / (2u * w->channels);
+            return 0;
+        }
+
+        pos = body + len + (len & 1);   // Chunks are padded to an even length
+    }
+    return -1;
+}
@@ -0,0 +1,23 @@
+#ifndef WAV_H
+#define WAV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+    Minimal RIFF/WAVE reader for 16-bit PCM, working directly on a
+    memory mapped file. Samples are not copied, only located.
+*/
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t channels;
+    const int16_t *samples;     // Interleaved, little-endian
+    size_t frames;              // Samples per channel
+} wav_t;
+
+bool wav_is_riff(const uint8_t *data, size_t size);
+int  wav_parse(wav_t *w, const uint8_t *data, size_t size);
+
+#endif
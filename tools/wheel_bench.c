@@ -0,0 +1,136 @@
+/*
+    Timer Wheel Bench
+
+    Drives timer_wheel.c with a simulated microsecond clock, the same
+    way scheduler.c drives it from ALARM0: the clock jumps straight to
+    whatever wheel_next() says is the earliest deadline, wheel_run()
+    fires it, and the callback may schedule more work.
+
+    Checks that every deadline fires exactly on time and in order
+    (including deadlines more than a lap out and across the 32-bit
+    wrap), then reports the host cost per insert, cancel and fired
+    event.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "timer_wheel.h"
+
+#define LIVE        1024
+#define EVENTS      2000000
+
+static uint32_t sim_now;
+static uint32_t last_fired;
+static uint64_t fired;
+static uint64_t late;
+static uint64_t out_of_order;
+
+static uint32_t rng = 0x12345678;
+static uint32_t xorshift() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static timer_wheel_t wheel;
+static deadline_t timers[LIVE];
+
+// Mix of key-gap sized delays and long ones that are several laps out
+static uint32_t random_delay() {
+    uint32_t r = xorshift();
+    if ((r & 7) == 0) return 1 + r % 20000000;      // Up to 20s
+    return 1 + r % 3200000;                          // Up to a sequence gap
+}
+
+static void on_fire(void *arg) {
+    deadline_t *d = arg;
+
+    if (d->when != sim_now) late++;
+    if ((int32_t)(sim_now - last_fired) < 0) out_of_order++;
+    last_fired = sim_now;
+    fired++;
+
+    // Keep the wheel populated: re-arm, sometimes cancelling another timer on the way
+    wheel_insert(&wheel, d, sim_now + random_delay(), on_fire, d);
+    if ((xorshift() & 3) == 0) {
+        deadline_t *victim = &timers[xorshift() % LIVE];
+        if (victim != d) {
+            wheel_cancel(&wheel, victim);
+            wheel_insert(&wheel, victim, sim_now + random_delay(), on_fire, victim);
+        }
+    }
+}
+
+// Event driven run, the clock only ever moves to the next deadline
+static void correctness(uint32_t start) {
+    sim_now = start;
+    last_fired = start;
+    wheel_init(&wheel, sim_now);
+    for (int i = 0; i < LIVE; i++) wheel_insert(&wheel, &timers[i], sim_now + random_delay(), on_fire, &timers[i]);
+
+    uint64_t target = fired + EVENTS / 4;
+    uint32_t next;
+    while (fired < target && wheel_next(&wheel, sim_now, &next)) {
+        sim_now = next;
+        wheel_run(&wheel, sim_now);
+    }
+    for (int i = 0; i < LIVE; i++) wheel_cancel(&wheel, &timers[i]);
+}
+
+static void noop(void *arg) {
+}
+
+int main() {
+    // Correctness, once from zero and once just before the 32-bit wrap
+    correctness(0);
+    correctness(0xFFF00000u);
+    printf("Fired %llu deadlines: %llu late, %llu out of order, %u left pending\n",
+           (unsigned long long)fired, (unsigned long long)late, (unsigned long long)out_of_order, wheel.pending);
+
+    // Insert / cancel cost with LIVE timers on the wheel
+    uint32_t *delays = malloc(EVENTS * sizeof(uint32_t));
+    for (int i = 0; i < EVENTS; i++) delays[i] = random_delay();
+
+    wheel_init(&wheel, 0);
+    double t0 = now_ns();
+    for (int i = 0; i < EVENTS; i++) wheel_insert(&wheel, &timers[i % LIVE], delays[i], noop, NULL);
+    double t1 = now_ns();
+    for (int r = 0; r < EVENTS / LIVE; r++) {
+        for (int i = 0; i < LIVE; i++) wheel_cancel(&wheel, &timers[i]);
+        for (int i = 0; i < LIVE; i++) wheel_insert(&wheel, &timers[i], delays[i], noop, NULL);
+    }
+    double t2 = now_ns();
+
+    // Firing cost, including finding the next deadline for the alarm each time
+    for (int i = 0; i < LIVE; i++) wheel_cancel(&wheel, &timers[i]);
+    uint64_t before = fired;
+    sim_now = 0;
+    last_fired = 0;
+    wheel_init(&wheel, 0);
+    for (int i = 0; i < LIVE; i++) wheel_insert(&wheel, &timers[i], random_delay(), on_fire, &timers[i]);
+    double t3 = now_ns();
+    uint32_t next;
+    while (fired - before < EVENTS && wheel_next(&wheel, sim_now, &next)) {
+        sim_now = next;
+        wheel_run(&wheel, sim_now);
+    }
+    double t4 = now_ns();
+
+    int rounds = EVENTS / LIVE;
+    printf("insert (re-arm):        %6.1f ns\n", (t1 - t0) / EVENTS);
+    printf("cancel + insert:        %6.1f ns\n", (t2 - t1) / (rounds * LIVE));
+    printf("fire (next + run + cb): %6.1f ns per event, %d live timers\n", (t4 - t3) / (double)(fired - before), LIVE);
+
+    free(delays);
+    return late || out_of_order ? 1 : 0;
+}